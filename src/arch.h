@@ -10,3 +10,15 @@
         #define SAGITTAR_HAS_BMI2 0
     #endif
 #endif
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+    #define SAGITTAR_HAS_AVX512 1
+#else
+    #define SAGITTAR_HAS_AVX512 0
+#endif
+
+#if defined(__AVX2__)
+    #define SAGITTAR_HAS_AVX2 1
+#else
+    #define SAGITTAR_HAS_AVX2 0
+#endif
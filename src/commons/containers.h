@@ -4,61 +4,66 @@
 
 namespace sagittar::containers {
 
+    // Fixed-capacity list with uninitialized storage.
+    // Elements are constructed in place on append, so creating a list costs nothing. Appends are
+    // only bounds-checked in debug builds.
     template<typename T, std::size_t Capacity = 256>
-    class ArrayList: public std::array<T, Capacity> {
-       private:
-        std::size_t current_size = 0;
+    class ArrayList final {
+        static_assert(std::is_trivially_destructible_v<T>);
 
        public:
+        using value_type     = T;
+        using iterator       = T*;
+        using const_iterator = const T*;
+
+        ArrayList() noexcept {}
+        ArrayList(const ArrayList&)            = delete;
+        ArrayList(ArrayList&&)                 = delete;
+        ArrayList& operator=(const ArrayList&) = delete;
+        ArrayList& operator=(ArrayList&&)      = delete;
+        ~ArrayList()                           = default;
+
         template<typename... Args>
-        void emplace(size_t position, Args&&... args) {
-            if (position > current_size || current_size >= Capacity)
-            {
-                throw std::out_of_range("Invalid position or ArrayList is full.");
-            }
-
-            // Shift elements to the right to make space for the new element
-            for (size_t i = current_size; i > position; --i)
-            {
-                (*this)[i] = std::move((*this)[i - 1]);
-            }
-
-            // Construct the new element in place
-            (*this)[position] = T(std::forward<Args>(args)...);
-            ++current_size;
+        inline void emplace_back(Args&&... args) {
+            assert(current_size < Capacity);
+            std::construct_at(&items[current_size++], std::forward<Args>(args)...);
         }
 
-        template<typename... Args>
-        void emplace_back(Args&&... args) {
-            if (current_size >= Capacity)
-            {
-                throw std::out_of_range("ArrayList is full: Cannot emplace_back.");
-            }
-
-            // Construct the new element at the back
-            (*this)[current_size++] = T(std::forward<Args>(args)...);
+        inline void push(const T& t) {
+            assert(current_size < Capacity);
+            std::construct_at(&items[current_size++], t);
         }
 
-        void push(T t) {
-            if (current_size >= Capacity)
-            {
-                throw std::out_of_range("ArrayList is full: Cannot push.");
-            }
-            (*this)[current_size++] = t;
+        inline void clear() { current_size = 0; }
+
+        [[nodiscard]] inline std::size_t size() const { return current_size; }
+
+        [[nodiscard]] static constexpr std::size_t capacity() { return Capacity; }
+
+        [[nodiscard]] inline T& operator[](const std::size_t i) {
+            assert(i < current_size);
+            return items[i];
         }
 
-        size_t size() const { return current_size; }
+        [[nodiscard]] inline const T& operator[](const std::size_t i) const {
+            assert(i < current_size);
+            return items[i];
+        }
 
-        typedef typename std::array<T, Capacity>::iterator       iterator;
-        typedef typename std::array<T, Capacity>::const_iterator const_iterator;
+        iterator begin() { return items; }
 
-        iterator begin() { return std::array<T, Capacity>::begin(); }
+        iterator end() { return items + current_size; }
 
-        iterator end() { return std::array<T, Capacity>::begin() + current_size; }
+        const_iterator begin() const { return items; }
 
-        const_iterator begin() const { return std::array<T, Capacity>::begin(); }
+        const_iterator end() const { return items + current_size; }
 
-        const_iterator end() const { return std::array<T, Capacity>::begin() + current_size; }
+       private:
+        // Members of an anonymous union are not initialized by the enclosing constructor
+        union {
+            T items[Capacity];
+        };
+        std::size_t current_size = 0;
     };
 
 }
@@ -1,6 +1,7 @@
 #include "uci.h"
 #include "commons/utils.h"
 #include "core/position.h"
+#include "eval/evalcache.h"
 #include "search/params.h"
 #include "search/types.h"
 
@@ -15,6 +16,12 @@ namespace sagittar::comms::uci {
         ss << "id author the Sagittar developers (see AUTHORS file)\n";
         ss << "option name Hash type spin default 16 min 1 max 512\n";
         ss << "option name Threads type spin default 1 min 1 max 4\n";
+        ss << "option name EvalCache type spin default " << eval::DEFAULT_EVAL_CACHE_SIZE_MB
+           << " min 0 max 64\n";
+        ss << "option name Eval type combo default " << (engine.usesNNUE() ? "NNUE" : "HCE")
+           << " var HCE var NNUE\n";
+        ss << "option name EvalFile type string default <empty>\n";
+        ss << "option name TBPath type string default <empty>\n";
 #ifdef EXTERNAL_TUNE
         for (auto& param : search::params::ParameterRegistry::instance())
         {
@@ -56,6 +63,40 @@ namespace sagittar::comms::uci {
                 engine.setThreadCount(threads);
             }
         }
+        else if (id == "EvalCache")
+        {
+            const std::size_t cachesize = static_cast<std::size_t>(std::stoi(value));
+            if (cachesize <= 64)
+            {
+                engine.setEvalCacheSize(cachesize);
+            }
+        }
+        else if (id == "Eval")
+        {
+            if (!engine.setUseNNUE(value == "NNUE"))
+            {
+                std::cout << "info string No network loaded, set EvalFile first" << std::endl;
+            }
+        }
+        else if (id == "EvalFile")
+        {
+            // The path runs to the end of the line and may contain spaces
+            const std::size_t value_pos = input.find(" value ");
+            const std::string path =
+              (value_pos == std::string::npos) ? "" : input.substr(value_pos + 7);
+            if (!engine.setEvalFile(path))
+            {
+                std::cout << "info string Could not load network " << path << std::endl;
+            }
+        }
+        else if (id == "TBPath")
+        {
+            const std::size_t value_pos = input.find(" value ");
+            const std::string path =
+              (value_pos == std::string::npos) ? "" : input.substr(value_pos + 7);
+            const std::size_t count = engine.setTablebasePath(path);
+            std::cout << "info string Loaded " << count << " tablebases from " << path << std::endl;
+        }
 #ifdef EXTERNAL_TUNE
         else
         {
@@ -192,6 +233,14 @@ namespace sagittar::comms::uci {
             {
                 ss << "cp " << (int) result.score;
             }
+            if (result.bound == search::ScoreBound::LOWERBOUND)
+            {
+                ss << " lowerbound";
+            }
+            else if (result.bound == search::ScoreBound::UPPERBOUND)
+            {
+                ss << " upperbound";
+            }
             ss << " depth " << (unsigned int) result.depth;
             ss << " nodes " << (size_t) result.nodes;
             ss << " time " << (unsigned long long) result.time;
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "commons/pch.h"
+#include "core/types.h"
+
+namespace sagittar {
+
+    // Keys of the positions leading to the current one, oldest first.
+    // The game history is a read-only view shared by all search workers, the keys pushed during
+    // search go to a fixed-capacity stack owned by each worker.
+    class KeyHistory final {
+       public:
+        static constexpr std::size_t SEARCH_CAPACITY = 128;
+
+        KeyHistory() = default;
+        explicit KeyHistory(std::span<const u64> game) :
+            m_game(game) {}
+        KeyHistory(const KeyHistory&)            = delete;
+        KeyHistory(KeyHistory&&)                 = delete;
+        KeyHistory& operator=(const KeyHistory&) = delete;
+        KeyHistory& operator=(KeyHistory&&)      = delete;
+        ~KeyHistory()                            = default;
+
+        inline void push(const u64 key) {
+            assert(m_size < SEARCH_CAPACITY);
+            m_stack[m_size++] = key;
+        }
+
+        inline void pop() {
+            assert(m_size > 0);
+            m_size--;
+        }
+
+        [[nodiscard]] inline std::size_t size() const { return m_game.size() + m_size; }
+
+        // Key of the position i plies ago, 1 <= i <= size()
+        [[nodiscard]] inline u64 pliesAgo(const std::size_t i) const {
+            assert(i >= 1 && i <= size());
+            return (i <= m_size) ? m_stack[m_size - i] : m_game[size() - i];
+        }
+
+       private:
+        alignas(64) std::array<u64, SEARCH_CAPACITY> m_stack;
+        std::size_t          m_size{0};
+        std::span<const u64> m_game{};
+    };
+
+}
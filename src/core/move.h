@@ -77,13 +77,13 @@ namespace sagittar {
 
     struct ExtMove final {
         Move move{};
-        i16  score;
+        i32  score;
 
         ExtMove() noexcept :
             move(),
             score(0) {}
 
-        ExtMove(const Move& m, i16 s) noexcept :
+        ExtMove(const Move& m, i32 s) noexcept :
             move(m),
             score(s) {}
 
@@ -308,7 +308,7 @@ namespace sagittar {
         constexpr BitBoard not_promo_dest = ~promo_dest;
         constexpr BitBoard ep_target_rank = (US == Color::WHITE) ? RANK_6_BB : RANK_3_BB;
 
-        const BitBoard pawns     = pos.pieces(US, PieceType::PAWN);
+        BitBoard       pawns     = pos.pieces(US, PieceType::PAWN);
         const BitBoard king_them = pos.pieces(them, PieceType::KING);
         const BitBoard enemies   = pos.pieces(them) ^ king_them;
         const BitBoard empty     = pos.empty();
@@ -317,6 +317,12 @@ namespace sagittar {
         const BitBoard ep_target_bb =
           (ep_target != Square::NO_SQ) ? (BB(ep_target) & ep_target_rank) : BitBoard{};
 
+        if constexpr (T == MovegenType::CHECK_EVASIONS)
+        {
+            // A pinned piece can never resolve a check
+            pawns &= ~pos.pinned(US);
+        }
+
         BitBoard pawns_fwd, sgl_push, dbl_push, fwd_l, fwd_r;
 
         if constexpr (US == Color::WHITE)
@@ -494,10 +500,27 @@ namespace sagittar {
           ((PT == PieceType::KNIGHT) || (PT == PieceType::KING)) ? (enemies | empty) : occupied;
 
         BitBoard bb = pos.pieces(US, PT);
+        BitBoard pinned{};
+        if constexpr (PT != PieceType::KING)
+        {
+            pinned = pos.pinned(US);
+            // A pinned knight can never move, and no pinned piece can resolve a check
+            if constexpr ((PT == PieceType::KNIGHT) || (T == MovegenType::CHECK_EVASIONS))
+            {
+                bb &= ~pinned;
+                pinned = BitBoard{};
+            }
+        }
+
         while (bb)
         {
-            const Square   from  = static_cast<Square>(bb.pop_lsb());
-            const BitBoard attks = attacks<PT>(from, occ);
+            const Square from  = static_cast<Square>(bb.pop_lsb());
+            BitBoard     attks = attacks<PT>(from, occ);
+            if (pinned & BB(from))
+            {
+                // A pinned slider stays on the line through its king
+                attks &= line(from, pos.kingSq());
+            }
 
             BitBoard captures = attks & enemies;
             if constexpr (T == MovegenType::CHECK_EVASIONS)
@@ -629,6 +652,13 @@ namespace sagittar {
         return 0ULL;
     }
 
+    template BitBoard attacks<PieceType::PAWN>(const Square, const BitBoard, const Color);
+    template BitBoard attacks<PieceType::KNIGHT>(const Square, const BitBoard, const Color);
+    template BitBoard attacks<PieceType::BISHOP>(const Square, const BitBoard, const Color);
+    template BitBoard attacks<PieceType::ROOK>(const Square, const BitBoard, const Color);
+    template BitBoard attacks<PieceType::QUEEN>(const Square, const BitBoard, const Color);
+    template BitBoard attacks<PieceType::KING>(const Square, const BitBoard, const Color);
+
     BitBoard squareAttackers(const Position& pos, const Square sq, const Color attacked_by) {
         const BitBoard occ  = pos.occupied();
         const BitBoard op_P = pos.pieces(attacked_by, PieceType::PAWN);
@@ -647,9 +677,91 @@ namespace sagittar {
         // clang-format on
     }
 
+    template<PieceType PT, Color US>
+    static void pseudolegalMovesPieceChecks(containers::ArrayList<Move>* moves,
+                                            const Position&              pos,
+                                            const BitBoard               check_squares) {
+        const BitBoard occupied = pos.occupied();
+        const BitBoard empty    = ~occupied;
+        const BitBoard occ      = (PT == PieceType::KNIGHT) ? empty : occupied;
+
+        BitBoard bb = pos.pieces(US, PT);
+        while (bb)
+        {
+            const Square from   = static_cast<Square>(bb.pop_lsb());
+            BitBoard     quites = attacks<PT>(from, occ) & empty & check_squares;
+            while (quites)
+            {
+                const Square to = static_cast<Square>(quites.pop_lsb());
+                moves->emplace_back(from, to, MoveFlag::MOVE_QUIET);
+            }
+        }
+    }
+
+    template<Color US>
+    static void pseudolegalMovesQuietChecks(containers::ArrayList<Move>* moves,
+                                            const Position&              pos) {
+        assert(pos.checkers().is_empty());
+
+        constexpr Color    them           = colorFlip(US);
+        constexpr BitBoard not_promo_dest = (US == Color::WHITE) ? ~RANK_8_BB : ~RANK_1_BB;
+        constexpr BitBoard all_squares    = ~BitBoard{};
+
+        const Square   ksq_them = static_cast<Square>(pos.pieces(them, PieceType::KING).lsb());
+        const BitBoard occupied = pos.occupied();
+        const BitBoard empty    = ~occupied;
+
+        // Squares from which a piece of each type would attack the enemy king
+        const BitBoard pawn_checks   = attacks<PieceType::PAWN>(ksq_them, all_squares, them);
+        const BitBoard knight_checks = attacks<PieceType::KNIGHT>(ksq_them, all_squares);
+        const BitBoard bishop_checks = attacks<PieceType::BISHOP>(ksq_them, occupied);
+        const BitBoard rook_checks   = attacks<PieceType::ROOK>(ksq_them, occupied);
+
+        // Pawn pushes, promotions are left to the capture/promotion generators
+        const BitBoard pawns = pos.pieces(US, PieceType::PAWN);
+        BitBoard       sgl_push, dbl_push;
+        int            dir;
+        if constexpr (US == Color::WHITE)
+        {
+            sgl_push = shift<Direction::NORTH>(pawns) & empty & not_promo_dest;
+            dbl_push = shift<Direction::NORTH>(sgl_push) & RANK_4_BB & empty;
+            dir      = Direction::NORTH;
+        }
+        else
+        {
+            sgl_push = shift<Direction::SOUTH>(pawns) & empty & not_promo_dest;
+            dbl_push = shift<Direction::SOUTH>(sgl_push) & RANK_5_BB & empty;
+            dir      = Direction::SOUTH;
+        }
+
+        BitBoard bb = sgl_push & pawn_checks;
+        while (bb)
+        {
+            const Square to   = static_cast<Square>(bb.pop_lsb());
+            const Square from = static_cast<Square>(to - dir);
+            moves->emplace_back(from, to, MoveFlag::MOVE_QUIET);
+        }
+
+        bb = dbl_push & pawn_checks;
+        while (bb)
+        {
+            const Square to   = static_cast<Square>(bb.pop_lsb());
+            const Square from = static_cast<Square>(to - (2 * dir));
+            moves->emplace_back(from, to, MoveFlag::MOVE_QUIET_PAWN_DBL_PUSH);
+        }
+
+        pseudolegalMovesPieceChecks<PieceType::QUEEN, US>(moves, pos, bishop_checks | rook_checks);
+        pseudolegalMovesPieceChecks<PieceType::ROOK, US>(moves, pos, rook_checks);
+        pseudolegalMovesPieceChecks<PieceType::BISHOP, US>(moves, pos, bishop_checks);
+        pseudolegalMovesPieceChecks<PieceType::KNIGHT, US>(moves, pos, knight_checks);
+    }
+
     template<Color US, MovegenType T>
     static void pseudolegalMovesColor(containers::ArrayList<Move>* moves, const Position& pos) {
-        pseudolegalMovesPiece<PieceType::KING, US, T>(moves, pos);
+        // The king escapes a check by itself, its moves are never restricted to the check line
+        constexpr MovegenType king_type =
+          (T == MovegenType::CHECK_EVASIONS) ? MovegenType::ALL : T;
+        pseudolegalMovesPiece<PieceType::KING, US, king_type>(moves, pos);
 
         if constexpr (T != MovegenType::CAPTURES)
         {
@@ -687,22 +799,45 @@ namespace sagittar {
         }
     }
 
+    template<Color US, MovegenType T>
+    void pseudolegalMoves(containers::ArrayList<Move>* moves, const Position& pos) {
+        assert(pos.stm() == US);
+
+        if constexpr (T == MovegenType::QUIET_CHECKS)
+        {
+            pseudolegalMovesQuietChecks<US>(moves, pos);
+        }
+        else
+        {
+            pseudolegalMovesColor<US, T>(moves, pos);
+        }
+    }
+
     template<MovegenType T>
     void pseudolegalMoves(containers::ArrayList<Move>* moves, const Position& pos) {
         if (pos.stm() == Color::WHITE)
         {
-            pseudolegalMovesColor<Color::WHITE, T>(moves, pos);
+            pseudolegalMoves<Color::WHITE, T>(moves, pos);
         }
         else
         {
-            pseudolegalMovesColor<Color::BLACK, T>(moves, pos);
+            pseudolegalMoves<Color::BLACK, T>(moves, pos);
         }
     }
 
-    template void pseudolegalMoves<MovegenType::ALL>(containers::ArrayList<Move>* moves,
-                                                     const Position&              pos);
-    template void pseudolegalMoves<MovegenType::CAPTURES>(containers::ArrayList<Move>* moves,
-                                                          const Position&              pos);
-    template void pseudolegalMoves<MovegenType::CHECK_EVASIONS>(containers::ArrayList<Move>* moves,
-                                                                const Position&              pos);
+    // clang-format off
+    template void pseudolegalMoves<MovegenType::ALL>(containers::ArrayList<Move>*, const Position&);
+    template void pseudolegalMoves<MovegenType::CAPTURES>(containers::ArrayList<Move>*, const Position&);
+    template void pseudolegalMoves<MovegenType::CHECK_EVASIONS>(containers::ArrayList<Move>*, const Position&);
+    template void pseudolegalMoves<MovegenType::QUIET_CHECKS>(containers::ArrayList<Move>*, const Position&);
+
+    template void pseudolegalMoves<Color::WHITE, MovegenType::ALL>(containers::ArrayList<Move>*, const Position&);
+    template void pseudolegalMoves<Color::WHITE, MovegenType::CAPTURES>(containers::ArrayList<Move>*, const Position&);
+    template void pseudolegalMoves<Color::WHITE, MovegenType::CHECK_EVASIONS>(containers::ArrayList<Move>*, const Position&);
+    template void pseudolegalMoves<Color::WHITE, MovegenType::QUIET_CHECKS>(containers::ArrayList<Move>*, const Position&);
+    template void pseudolegalMoves<Color::BLACK, MovegenType::ALL>(containers::ArrayList<Move>*, const Position&);
+    template void pseudolegalMoves<Color::BLACK, MovegenType::CAPTURES>(containers::ArrayList<Move>*, const Position&);
+    template void pseudolegalMoves<Color::BLACK, MovegenType::CHECK_EVASIONS>(containers::ArrayList<Move>*, const Position&);
+    template void pseudolegalMoves<Color::BLACK, MovegenType::QUIET_CHECKS>(containers::ArrayList<Move>*, const Position&);
+    // clang-format on
 }
@@ -12,7 +12,8 @@ namespace sagittar {
     enum class MovegenType {
         ALL,
         CAPTURES,
-        CHECK_EVASIONS
+        CHECK_EVASIONS,
+        QUIET_CHECKS  // Non-capture, non-promotion moves giving direct check
     };
 
     void movegen_initialize();
@@ -25,4 +26,8 @@ namespace sagittar {
     template<MovegenType T>
     void pseudolegalMoves(containers::ArrayList<Move>* moves, const Position& pos);
 
+    // Side to move known at compile time
+    template<Color US, MovegenType T>
+    void pseudolegalMoves(containers::ArrayList<Move>* moves, const Position& pos);
+
 }
@@ -1,6 +1,7 @@
 #include "position.h"
 #include "commons/utils.h"
 #include "core/movegen.h"
+#include "core/psqt.h"
 
 namespace sagittar {
 
@@ -23,6 +24,73 @@ namespace sagittar {
     static u64                                 ZOBRIST_SIDE;
     static int constexpr ZOBRIST_EP_IDX = 14;
 
+    // Cuckoo tables of the keys of reversible moves (Marcel van Kervinck's method)
+    // A key is stored at one of its two hash slots, the move that produces it alongside.
+    static constexpr std::size_t         CUCKOO_SIZE = 8192;
+    static std::array<u64, CUCKOO_SIZE>  CUCKOO_KEYS;
+    static std::array<Move, CUCKOO_SIZE> CUCKOO_MOVES;
+
+    static constexpr std::size_t cuckooH1(const u64 key) { return key & (CUCKOO_SIZE - 1); }
+    static constexpr std::size_t cuckooH2(const u64 key) {
+        return (key >> 16) & (CUCKOO_SIZE - 1);
+    }
+
+    template<PieceType PT>
+    static void initCuckooPiece(const Color c, std::size_t* count) {
+        const Piece    piece = pieceCreate(PT, c);
+        const BitBoard occupancy =
+          (PT == PieceType::KNIGHT || PT == PieceType::KING) ? ~BitBoard{} : BitBoard{};
+
+        for (u8 s1 = Square::A1; s1 <= Square::H8; s1++)
+        {
+            const BitBoard targets = attacks<PT>(static_cast<Square>(s1), occupancy);
+
+            for (u8 s2 = s1 + 1; s2 <= Square::H8; s2++)
+            {
+                if ((targets & BB(s2)).is_empty())
+                {
+                    continue;
+                }
+
+                Move move(static_cast<Square>(s1), static_cast<Square>(s2), MoveFlag::MOVE_QUIET);
+                u64  key = ZOBRIST_TABLE[piece][s1] ^ ZOBRIST_TABLE[piece][s2] ^ ZOBRIST_SIDE;
+
+                std::size_t i = cuckooH1(key);
+                while (true)
+                {
+                    std::swap(CUCKOO_KEYS[i], key);
+                    std::swap(CUCKOO_MOVES[i], move);
+                    if (move == NULL_MOVE)
+                    {
+                        break;
+                    }
+                    // Push the evicted entry to its other slot
+                    i = (i == cuckooH1(key)) ? cuckooH2(key) : cuckooH1(key);
+                }
+
+                (*count)++;
+            }
+        }
+    }
+
+    static void initCuckoo() {
+        CUCKOO_KEYS.fill(0ULL);
+        CUCKOO_MOVES.fill(NULL_MOVE);
+
+        [[maybe_unused]] std::size_t count = 0;
+
+        for (const Color c : {Color::WHITE, Color::BLACK})
+        {
+            initCuckooPiece<PieceType::KNIGHT>(c, &count);
+            initCuckooPiece<PieceType::BISHOP>(c, &count);
+            initCuckooPiece<PieceType::ROOK>(c, &count);
+            initCuckooPiece<PieceType::QUEEN>(c, &count);
+            initCuckooPiece<PieceType::KING>(c, &count);
+        }
+
+        assert(count == 3668);
+    }
+
     void Position::initialize() {
 
         for (u8 p = Piece::WHITE_PAWN; p <= Piece::NO_PIECE; p++)
@@ -41,12 +109,15 @@ namespace sagittar {
         ZOBRIST_SIDE = utils::prng();
 
         movegen_initialize();
+
+        initCuckoo();
     }
 
     Position::Position() :
         m_bb_pieces({}),
         m_bb_colors({}),
         m_checkers(0ULL),
+        m_check_squares({}),
         m_king_sq(Square::NO_SQ),
         m_stm(Color::WHITE),
         m_ca_rights(0),
@@ -54,16 +125,43 @@ namespace sagittar {
         m_halfmoves(0),
         m_fullmoves(0),
         m_ply_count(0),
+        m_plies_from_null(0),
         m_key(0ULL),
-        m_pawn_key(0ULL) {
+        m_pawn_key(0ULL),
+        m_non_pawn_key({}),
+        m_material_key(0ULL),
+        m_psqt(0),
+        m_phase(0),
+        m_king_blockers({}),
+        m_threats({}) {
         m_board.fill(Piece::NO_PIECE);
     }
 
     void Position::reset() { *this = Position{}; }
 
+    void Position::resetPsqt() {
+        m_psqt  = 0;
+        m_phase = 0;
+
+        for (u8 sq = Square::A1; sq <= Square::H8; sq++)
+        {
+            const Piece p = m_board[sq];
+
+            if (p == Piece::NO_PIECE)
+            {
+                continue;
+            }
+
+            m_psqt += PIECE_SQUARE_SCORES[p][sq];
+            m_phase += PHASE_WEIGHTS[pieceTypeOf(p)];
+        }
+    }
+
     void Position::resetHash() {
-        m_key      = 0ULL;
-        m_pawn_key = 0ULL;
+        m_key          = 0ULL;
+        m_pawn_key     = 0ULL;
+        m_non_pawn_key = {};
+        m_material_key = 0ULL;
 
         // Side to move
         if (m_stm == Color::WHITE)
@@ -96,6 +194,23 @@ namespace sagittar {
             {
                 m_pawn_key ^= ZOBRIST_TABLE[p][sq];
             }
+            else
+            {
+                m_non_pawn_key[pieceColorOf(p)] ^= ZOBRIST_TABLE[p][sq];
+            }
+        }
+
+        // Material, the n-th piece of a kind hashes as if it stood on square n
+        for (const Color c : {Color::WHITE, Color::BLACK})
+        {
+            for (u8 pt = PieceType::PAWN; pt <= PieceType::KING; pt++)
+            {
+                const Piece p = pieceCreate(static_cast<PieceType>(pt), c);
+                for (u8 n = 0; n < pieceCount(p); n++)
+                {
+                    m_material_key ^= ZOBRIST_TABLE[p][n];
+                }
+            }
         }
     }
 
@@ -250,8 +365,20 @@ namespace sagittar {
         m_king_sq        = static_cast<Square>(king_bb.pop_lsb());
         m_checkers       = squareAttackers(*this, m_king_sq, colorFlip(m_stm));
 
+        if (m_stm == Color::WHITE)
+        {
+            updateCheckInfo<Color::WHITE>();
+        }
+        else
+        {
+            updateCheckInfo<Color::BLACK>();
+        }
+        updateThreats();
+
         // Reset Hash
         resetHash();
+
+        resetPsqt();
     }
 
     std::string Position::toFen() const {
@@ -355,8 +482,10 @@ namespace sagittar {
         constexpr bool  is_promotion = MOVE_IS_PROMOTION(F);
         constexpr Color them         = colorFlip(US);
 
-        u64 key_local      = m_key;
-        u64 pawn_key_local = m_pawn_key;
+        u64 key_local               = m_key;
+        u64 pawn_key_local          = m_pawn_key;
+        u64 non_pawn_key_local_us   = m_non_pawn_key[US];
+        u64 non_pawn_key_local_them = m_non_pawn_key[them];
 
         key_local ^=
           (m_ep_target == Square::NO_SQ) ? 0ULL : ZOBRIST_TABLE[ZOBRIST_EP_IDX][m_ep_target];
@@ -365,6 +494,7 @@ namespace sagittar {
         ++m_halfmoves;
         m_fullmoves += (m_stm == Color::BLACK);
         ++m_ply_count;
+        ++m_plies_from_null;
 
         const Square from = move.from();
         const Square to   = move.to();
@@ -384,11 +514,17 @@ namespace sagittar {
 
         key_local ^= ZOBRIST_TABLE[move_p][from];
         key_local ^= ZOBRIST_TABLE[move_p][to];
+        m_psqt += PIECE_SQUARE_SCORES[move_p][to] - PIECE_SQUARE_SCORES[move_p][from];
         if (move_pt == PieceType::PAWN)
         {
             pawn_key_local ^= ZOBRIST_TABLE[move_p][from];
             pawn_key_local ^= ZOBRIST_TABLE[move_p][to];
         }
+        else
+        {
+            non_pawn_key_local_us ^= ZOBRIST_TABLE[move_p][from];
+            non_pawn_key_local_us ^= ZOBRIST_TABLE[move_p][to];
+        }
 
         if constexpr ((F == MoveFlag::MOVE_CASTLE_KING_SIDE)
                       || (F == MoveFlag::MOVE_CASTLE_QUEEN_SIDE))
@@ -409,6 +545,10 @@ namespace sagittar {
             m_board[ca_r_to_sq]   = rook;
             key_local ^= ZOBRIST_TABLE[rook][ca_r_from_sq];
             key_local ^= ZOBRIST_TABLE[rook][ca_r_to_sq];
+            non_pawn_key_local_us ^= ZOBRIST_TABLE[rook][ca_r_from_sq];
+            non_pawn_key_local_us ^= ZOBRIST_TABLE[rook][ca_r_to_sq];
+            m_psqt += PIECE_SQUARE_SCORES[rook][ca_r_to_sq];
+            m_psqt -= PIECE_SQUARE_SCORES[rook][ca_r_from_sq];
         }
         else if constexpr (F == MoveFlag::MOVE_QUIET_PAWN_DBL_PUSH)
         {
@@ -434,6 +574,8 @@ namespace sagittar {
                     m_board[ep_victim_sq] = Piece::NO_PIECE;
                     key_local ^= ZOBRIST_TABLE[ep_victim][ep_victim_sq];
                     pawn_key_local ^= ZOBRIST_TABLE[ep_victim][ep_victim_sq];
+                    m_psqt -= PIECE_SQUARE_SCORES[ep_victim][ep_victim_sq];
+                    m_material_key ^= ZOBRIST_TABLE[ep_victim][pieceCount(ep_victim)];
                 }
                 else
                 {
@@ -442,10 +584,17 @@ namespace sagittar {
                     m_bb_pieces[captured_pt] ^= move_mask_to;
                     m_bb_colors[them] ^= move_mask_to;
                     key_local ^= ZOBRIST_TABLE[captured_p][to];
+                    m_psqt -= PIECE_SQUARE_SCORES[captured_p][to];
+                    m_phase -= PHASE_WEIGHTS[captured_pt];
+                    m_material_key ^= ZOBRIST_TABLE[captured_p][pieceCount(captured_p)];
                     if (captured_pt == PieceType::PAWN)
                     {
                         pawn_key_local ^= ZOBRIST_TABLE[captured_p][to];
                     }
+                    else
+                    {
+                        non_pawn_key_local_them ^= ZOBRIST_TABLE[captured_p][to];
+                    }
                 }
             }
 
@@ -475,6 +624,11 @@ namespace sagittar {
                 key_local ^= ZOBRIST_TABLE[move_p][to];
                 key_local ^= ZOBRIST_TABLE[promoted][to];
                 pawn_key_local ^= ZOBRIST_TABLE[move_p][to];
+                non_pawn_key_local_us ^= ZOBRIST_TABLE[promoted][to];
+                m_psqt += PIECE_SQUARE_SCORES[promoted][to] - PIECE_SQUARE_SCORES[move_p][to];
+                m_phase += PHASE_WEIGHTS[promoted_pt];
+                m_material_key ^= ZOBRIST_TABLE[move_p][pieceCount(move_p)];
+                m_material_key ^= ZOBRIST_TABLE[promoted][pieceCount(promoted) - 1];
             }
         }
 
@@ -500,25 +654,191 @@ namespace sagittar {
         m_stm = colorFlip(m_stm);
         key_local ^= ZOBRIST_SIDE;
 
-        m_key      = key_local;
-        m_pawn_key = pawn_key_local;
+        updateCheckInfo<them>();
+        updateThreats();
+
+        m_key                = key_local;
+        m_pawn_key           = pawn_key_local;
+        m_non_pawn_key[US]   = non_pawn_key_local_us;
+        m_non_pawn_key[them] = non_pawn_key_local_them;
 
 #ifdef DEBUG
-        const u64 curr_key      = m_key;
-        const u64 curr_pawn_key = m_pawn_key;
+        const u64                curr_key          = m_key;
+        const u64                curr_pawn_key     = m_pawn_key;
+        const std::array<u64, 2> curr_non_pawn_key = m_non_pawn_key;
+        const u64                curr_material_key = m_material_key;
         resetHash();
         assert(m_key == curr_key);
         assert(m_pawn_key == curr_pawn_key);
+        assert(m_non_pawn_key == curr_non_pawn_key);
+        assert(m_material_key == curr_material_key);
+        const i32 curr_psqt  = m_psqt;
+        const i32 curr_phase = m_phase;
+        resetPsqt();
+        assert(m_psqt == curr_psqt);
+        assert(m_phase == curr_phase);
 #endif
 
         return is_valid_move;
     }
 
+    template<Color US>
+    void Position::updateCheckInfo() {
+        constexpr Color    them        = colorFlip(US);
+        constexpr BitBoard all_squares = ~BitBoard{};
+
+        const Square   ksq_them = static_cast<Square>(pieces(them, PieceType::KING).lsb());
+        const BitBoard occ      = occupied();
+
+        const BitBoard bishop_checks = attacks<PieceType::BISHOP>(ksq_them, occ);
+        const BitBoard rook_checks   = attacks<PieceType::ROOK>(ksq_them, occ);
+
+        m_check_squares[PieceType::PAWN]   = attacks<PieceType::PAWN>(ksq_them, all_squares, them);
+        m_check_squares[PieceType::KNIGHT] = attacks<PieceType::KNIGHT>(ksq_them, all_squares);
+        m_check_squares[PieceType::BISHOP] = bishop_checks;
+        m_check_squares[PieceType::ROOK]   = rook_checks;
+        m_check_squares[PieceType::QUEEN]  = bishop_checks | rook_checks;
+        m_check_squares[PieceType::KING]   = BitBoard{};
+    }
+
+    void Position::updateThreats() {
+        constexpr BitBoard all_squares = ~BitBoard{};
+
+        const BitBoard occ = occupied();
+
+        for (const Color c : {Color::WHITE, Color::BLACK})
+        {
+            const Color them = colorFlip(c);
+
+            // Enemy sliders that would see the king on an empty board, with exactly one piece in
+            // between
+            const Square   ksq     = static_cast<Square>(pieces(c, PieceType::KING).lsb());
+            const BitBoard queens  = pieces(them, PieceType::QUEEN);
+            const BitBoard bishops = pieces(them, PieceType::BISHOP) | queens;
+            const BitBoard rooks   = pieces(them, PieceType::ROOK) | queens;
+            BitBoard       snipers = (attacks<PieceType::BISHOP>(ksq, BitBoard{}) & bishops)
+                             | (attacks<PieceType::ROOK>(ksq, BitBoard{}) & rooks);
+
+            BitBoard blockers{};
+            while (snipers)
+            {
+                const Square   sniper_sq = static_cast<Square>(snipers.pop_lsb());
+                const BitBoard b         = between(sniper_sq, ksq) & occ;
+                if (b && !b.has_multiple())
+                {
+                    blockers |= b;
+                }
+            }
+            m_king_blockers[c] = blockers;
+
+            // Attacks of the enemy pieces, accumulated in order of value
+            const BitBoard pawns = pieces(them, PieceType::PAWN);
+            BitBoard       attacked;
+            if (them == Color::WHITE)
+            {
+                attacked = shift<Direction::NORTH_EAST>(pawns);
+                attacked |= shift<Direction::NORTH_WEST>(pawns);
+            }
+            else
+            {
+                attacked = shift<Direction::SOUTH_EAST>(pawns);
+                attacked |= shift<Direction::SOUTH_WEST>(pawns);
+            }
+            m_threats[c][0] = attacked;
+
+            BitBoard bb = pieces(them, PieceType::KNIGHT);
+            while (bb)
+            {
+                const Square sq = static_cast<Square>(bb.pop_lsb());
+                attacked |= attacks<PieceType::KNIGHT>(sq, all_squares);
+            }
+            bb = pieces(them, PieceType::BISHOP);
+            while (bb)
+            {
+                const Square sq = static_cast<Square>(bb.pop_lsb());
+                attacked |= attacks<PieceType::BISHOP>(sq, occ);
+            }
+            m_threats[c][1] = attacked;
+
+            bb = pieces(them, PieceType::ROOK);
+            while (bb)
+            {
+                const Square sq = static_cast<Square>(bb.pop_lsb());
+                attacked |= attacks<PieceType::ROOK>(sq, occ);
+            }
+            m_threats[c][2] = attacked;
+        }
+    }
+
+    BitBoard Position::kingBlockers(const Color c) const { return m_king_blockers[c]; }
+
+    BitBoard Position::pinned(const Color c) const { return kingBlockers(c) & m_bb_colors[c]; }
+
+    // Squares where a piece of the given color and type is attacked by a less valuable enemy piece
+    BitBoard Position::lowerValueThreats(const Color c, const PieceType pt) const {
+        switch (pt)
+        {
+            case PieceType::KNIGHT :
+            case PieceType::BISHOP :
+                return m_threats[c][0];
+            case PieceType::ROOK :
+                return m_threats[c][1];
+            case PieceType::QUEEN :
+                return m_threats[c][2];
+            default :
+                return BitBoard{};
+        }
+    }
+
+    template<Color US>
+    [[nodiscard]] bool Position::doMove(const Move& move) noexcept {
+        assert(m_stm == US);
+
+        if (pieceColorOf(pieceOn(move.from())) != US)
+        {
+            return false;
+        }
+
+        switch (move.flag())
+        {
+            case MOVE_QUIET :
+                return applyMove<US, MOVE_QUIET>(move);
+            case MOVE_QUIET_PAWN_DBL_PUSH :
+                return applyMove<US, MOVE_QUIET_PAWN_DBL_PUSH>(move);
+            case MOVE_CASTLE_KING_SIDE :
+                return applyMove<US, MOVE_CASTLE_KING_SIDE>(move);
+            case MOVE_CASTLE_QUEEN_SIDE :
+                return applyMove<US, MOVE_CASTLE_QUEEN_SIDE>(move);
+            case MOVE_CAPTURE :
+                return applyMove<US, MOVE_CAPTURE>(move);
+            case MOVE_CAPTURE_EP :
+                return applyMove<US, MOVE_CAPTURE_EP>(move);
+            case MOVE_PROMOTION_KNIGHT :
+                return applyMove<US, MOVE_PROMOTION_KNIGHT>(move);
+            case MOVE_PROMOTION_BISHOP :
+                return applyMove<US, MOVE_PROMOTION_BISHOP>(move);
+            case MOVE_PROMOTION_ROOK :
+                return applyMove<US, MOVE_PROMOTION_ROOK>(move);
+            case MOVE_PROMOTION_QUEEN :
+                return applyMove<US, MOVE_PROMOTION_QUEEN>(move);
+            case MOVE_CAPTURE_PROMOTION_KNIGHT :
+                return applyMove<US, MOVE_CAPTURE_PROMOTION_KNIGHT>(move);
+            case MOVE_CAPTURE_PROMOTION_BISHOP :
+                return applyMove<US, MOVE_CAPTURE_PROMOTION_BISHOP>(move);
+            case MOVE_CAPTURE_PROMOTION_ROOK :
+                return applyMove<US, MOVE_CAPTURE_PROMOTION_ROOK>(move);
+            case MOVE_CAPTURE_PROMOTION_QUEEN :
+                return applyMove<US, MOVE_CAPTURE_PROMOTION_QUEEN>(move);
+            default :
+                return false;
+        }
+    }
+
+    template bool Position::doMove<Color::WHITE>(const Move&) noexcept;
+    template bool Position::doMove<Color::BLACK>(const Move&) noexcept;
+
     [[nodiscard]] bool Position::doMove(const Move& move) noexcept {
-        const bool is_valid = (pieceColorOf(pieceOn(move.from())) == m_stm);
-        return (m_stm == Color::WHITE)
-               ? is_valid && (this->*apply_move_dispatch_table<Color::WHITE>[move.flag()])(move)
-               : is_valid && (this->*apply_move_dispatch_table<Color::BLACK>[move.flag()])(move);
+        return (m_stm == Color::WHITE) ? doMove<Color::WHITE>(move) : doMove<Color::BLACK>(move);
     }
 
     [[nodiscard]] bool Position::doMove(const std::string& move_str) noexcept {
@@ -674,6 +994,18 @@ namespace sagittar {
         m_ep_target = Square::NO_SQ;
         m_stm       = colorFlip(m_stm);
         m_key ^= ZOBRIST_SIDE;
+        if (m_stm == Color::WHITE)
+        {
+            updateCheckInfo<Color::WHITE>();
+        }
+        else
+        {
+            updateCheckInfo<Color::BLACK>();
+        }
+        // Keep the ply count in step with the search key history, but never look for
+        // repetitions across a null move
+        ++m_ply_count;
+        m_plies_from_null = 0;
     }
 
     BitBoard Position::pieces(const Color c) const { return m_bb_colors[c]; }
@@ -714,6 +1046,14 @@ namespace sagittar {
 
     u64 Position::pawn_key() const { return m_pawn_key; }
 
+    u64 Position::non_pawn_key(const Color c) const { return m_non_pawn_key[c]; }
+
+    u64 Position::material_key() const { return m_material_key; }
+
+    i32 Position::psqt() const { return m_psqt; }
+
+    i32 Position::phase() const { return m_phase; }
+
     bool Position::isValid() const {
         return (m_bb_pieces[PieceType::KING].count() == 2)
             && ((m_bb_pieces[PieceType::PAWN] & RANK_1_AND_8_BB).is_empty());
@@ -721,15 +1061,82 @@ namespace sagittar {
 
     bool Position::isInCheck() const { return !m_checkers.is_empty(); }
 
-    bool Position::isDrawn(std::span<u64> key_history) const {
+    // Whether a pseudolegal move of the side to move checks the enemy king, without making it
+    bool Position::givesCheck(const Move& move) const {
+        const Square    from     = move.from();
+        const Square    to       = move.to();
+        const PieceType pt       = pieceTypeOf(m_board[from]);
+        const Color     them     = colorFlip(m_stm);
+        const Square    ksq_them = static_cast<Square>(pieces(them, PieceType::KING).lsb());
+
+        // Direct check
+        if (m_check_squares[pt] & BB(to))
+        {
+            return true;
+        }
+
+        // Discovered check
+        const BitBoard discoverers = kingBlockers(them) & m_bb_colors[m_stm];
+        if ((discoverers & BB(from)) && !(line(from, ksq_them) & BB(to)))
+        {
+            return true;
+        }
+
+        const MoveFlag flag = move.flag();
+
+        if (move.isPromotion())
+        {
+            const BitBoard occ = occupied() ^ BB(from);
+            switch (flag)
+            {
+                case MOVE_PROMOTION_KNIGHT :
+                case MOVE_CAPTURE_PROMOTION_KNIGHT :
+                    return m_check_squares[PieceType::KNIGHT] & BB(to);
+                case MOVE_PROMOTION_BISHOP :
+                case MOVE_CAPTURE_PROMOTION_BISHOP :
+                    return attacks<PieceType::BISHOP>(to, occ) & BB(ksq_them);
+                case MOVE_PROMOTION_ROOK :
+                case MOVE_CAPTURE_PROMOTION_ROOK :
+                    return attacks<PieceType::ROOK>(to, occ) & BB(ksq_them);
+                default :
+                    return attacks<PieceType::QUEEN>(to, occ) & BB(ksq_them);
+            }
+        }
+
+        switch (flag)
+        {
+            case MOVE_CAPTURE_EP : {
+                // Both pawns leave their squares, either can uncover a slider
+                const Square   victim_sq = rf2sq(sq2rank(from), sq2file(to));
+                const BitBoard occ       = (occupied() ^ BB(from) ^ BB(victim_sq)) | BB(to);
+                const BitBoard queens    = pieces(m_stm, PieceType::QUEEN);
+                const BitBoard bishops   = pieces(m_stm, PieceType::BISHOP) | queens;
+                const BitBoard rooks     = pieces(m_stm, PieceType::ROOK) | queens;
+                return (attacks<PieceType::BISHOP>(ksq_them, occ) & bishops)
+                    || (attacks<PieceType::ROOK>(ksq_them, occ) & rooks);
+            }
+            case MOVE_CASTLE_KING_SIDE :
+            case MOVE_CASTLE_QUEEN_SIDE : {
+                const bool   king_side = (flag == MOVE_CASTLE_KING_SIDE);
+                const Rank   rank      = sq2rank(from);
+                const Square rook_from = rf2sq(rank, king_side ? File::FILE_H : File::FILE_A);
+                const Square rook_to   = rf2sq(rank, king_side ? File::FILE_F : File::FILE_D);
+                const BitBoard occ = (occupied() ^ BB(from) ^ BB(rook_from)) | BB(to) | BB(rook_to);
+                return attacks<PieceType::ROOK>(rook_to, occ) & BB(ksq_them);
+            }
+            default :
+                return false;
+        }
+    }
+
+    bool Position::isDrawn(const KeyHistory& key_history) const {
         assert(key_history.size() == static_cast<size_t>(m_ply_count));
 
-        const u64 key   = m_key;
-        const i32 start = std::max(m_ply_count - m_halfmoves, 0);
+        const i32 end = std::min<i32>(m_halfmoves, m_plies_from_null);
 
-        for (i32 i = m_ply_count - 2; i >= start; i -= 2)
+        for (i32 i = 2; i <= end; i += 2)
         {
-            if (key == key_history[i])
+            if (m_key == key_history.pliesAgo(i))
             {
                 return true;
             }
@@ -737,6 +1144,48 @@ namespace sagittar {
         return false;
     }
 
+    bool Position::hasUpcomingRepetition(const KeyHistory& key_history, const i32 ply) const {
+        assert(key_history.size() == static_cast<size_t>(m_ply_count));
+
+        const i32 end = std::min<i32>(m_halfmoves, m_plies_from_null);
+        if (end < 3)
+        {
+            return false;
+        }
+
+        const BitBoard occ = occupied();
+
+        // A position i plies ago differs from this one by a single reversible move of the
+        // side to move exactly when the key difference is in the cuckoo tables
+        for (i32 i = 3; i <= end; i += 2)
+        {
+            const u64 move_key = m_key ^ key_history.pliesAgo(i);
+
+            std::size_t j = cuckooH1(move_key);
+            if (CUCKOO_KEYS[j] != move_key)
+            {
+                j = cuckooH2(move_key);
+                if (CUCKOO_KEYS[j] != move_key)
+                {
+                    continue;
+                }
+            }
+
+            const Move move = CUCKOO_MOVES[j];
+            if ((between(move.from(), move.to()) & occ).is_empty())
+            {
+                // Only cycles closing inside the search tree count. Reaching a position
+                // of the game history once more is not a draw by itself.
+                if (ply > i)
+                {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
     void Position::display() const {
         std::ostringstream ss;
 
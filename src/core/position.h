@@ -3,6 +3,7 @@
 #include "commons/containers.h"
 #include "commons/pch.h"
 #include "core/bitboard.h"
+#include "core/keyhistory.h"
 #include "core/move.h"
 #include "core/types.h"
 
@@ -24,6 +25,8 @@ namespace sagittar {
         void        setFen(std::string, const bool full = true);
         std::string toFen() const;
 
+        [[nodiscard]] bool doMove(const Move&) noexcept;
+        template<Color US>
         [[nodiscard]] bool doMove(const Move&) noexcept;
         [[nodiscard]] bool doMove(const std::string&) noexcept;
         void               doNullMove();
@@ -47,6 +50,12 @@ namespace sagittar {
 
         inline BitBoard checkers() const { return m_checkers; }
         inline Square   kingSq() const { return m_king_sq; }
+        inline BitBoard checkSquares(const PieceType pt) const { return m_check_squares[pt]; }
+
+        // Threat maps, computed on first use after the pieces have moved
+        BitBoard kingBlockers(const Color) const;
+        BitBoard pinned(const Color) const;
+        BitBoard lowerValueThreats(const Color, const PieceType) const;
 
         Color  stm() const;
         u8     caRights() const;
@@ -55,10 +64,16 @@ namespace sagittar {
         u8     fullmoves() const;
         u64    key() const;
         u64    pawn_key() const;
+        u64    non_pawn_key(const Color) const;
+        u64    material_key() const;
+        i32    psqt() const;
+        i32    phase() const;
 
         bool isValid() const;
         bool isInCheck() const;
-        bool isDrawn(std::span<u64> key_history) const;
+        bool givesCheck(const Move&) const;
+        bool isDrawn(const KeyHistory& key_history) const;
+        bool hasUpcomingRepetition(const KeyHistory& key_history, const i32 ply) const;
 
         void display() const;
 
@@ -66,43 +81,21 @@ namespace sagittar {
 
        private:
         void resetHash();
+        void resetPsqt();
 
         template<Color US, MoveFlag F>
         bool applyMove(const Move& move) noexcept;
 
         template<Color US>
-        using ApplyMoveFn = bool (Position::*)(const Move&);
+        void updateCheckInfo();
 
-        template<Color US>
-        static constexpr std::array<ApplyMoveFn<US>, 16> apply_move_dispatch_table = []() {
-            std::array<ApplyMoveFn<US>, 16> table{};
-
-            table[MOVE_QUIET]               = &Position::applyMove<US, MOVE_QUIET>;
-            table[MOVE_QUIET_PAWN_DBL_PUSH] = &Position::applyMove<US, MOVE_QUIET_PAWN_DBL_PUSH>;
-            table[MOVE_CASTLE_KING_SIDE]    = &Position::applyMove<US, MOVE_CASTLE_KING_SIDE>;
-            table[MOVE_CASTLE_QUEEN_SIDE]   = &Position::applyMove<US, MOVE_CASTLE_QUEEN_SIDE>;
-            table[MOVE_CAPTURE]             = &Position::applyMove<US, MOVE_CAPTURE>;
-            table[MOVE_CAPTURE_EP]          = &Position::applyMove<US, MOVE_CAPTURE_EP>;
-            table[MOVE_PROMOTION_KNIGHT]    = &Position::applyMove<US, MOVE_PROMOTION_KNIGHT>;
-            table[MOVE_PROMOTION_BISHOP]    = &Position::applyMove<US, MOVE_PROMOTION_BISHOP>;
-            table[MOVE_PROMOTION_ROOK]      = &Position::applyMove<US, MOVE_PROMOTION_ROOK>;
-            table[MOVE_PROMOTION_QUEEN]     = &Position::applyMove<US, MOVE_PROMOTION_QUEEN>;
-            table[MOVE_CAPTURE_PROMOTION_KNIGHT] =
-              &Position::applyMove<US, MOVE_CAPTURE_PROMOTION_KNIGHT>;
-            table[MOVE_CAPTURE_PROMOTION_BISHOP] =
-              &Position::applyMove<US, MOVE_CAPTURE_PROMOTION_BISHOP>;
-            table[MOVE_CAPTURE_PROMOTION_ROOK] =
-              &Position::applyMove<US, MOVE_CAPTURE_PROMOTION_ROOK>;
-            table[MOVE_CAPTURE_PROMOTION_QUEEN] =
-              &Position::applyMove<US, MOVE_CAPTURE_PROMOTION_QUEEN>;
-
-            return table;
-        }();
+        void updateThreats();
 
         std::array<BitBoard, 6> m_bb_pieces;
         std::array<BitBoard, 2> m_bb_colors;
         std::array<Piece, 64>   m_board;
         BitBoard                m_checkers;
+        std::array<BitBoard, 6> m_check_squares;  // Where each piece type of the stm checks
         Square                  m_king_sq;
         Color                   m_stm;
         u8                      m_ca_rights;
@@ -110,8 +103,18 @@ namespace sagittar {
         u8                      m_halfmoves;
         u8                      m_fullmoves;
         i32                     m_ply_count;
+        i32                     m_plies_from_null;
         u64                     m_key;
         u64                     m_pawn_key;
+        std::array<u64, 2>      m_non_pawn_key;
+        u64                     m_material_key;  // Piece counts, see resetHash
+        i32                     m_psqt;   // Packed S(mg, eg) material and PSQT, white relative
+        i32                     m_phase;  // Sum of the phase weights of the pieces on the board
+
+        // [color] Pieces of either color between the king and an enemy slider, alone on the line
+        std::array<BitBoard, 2> m_king_blockers;
+        // [color][n] Squares attacked by enemy pawns (0), pawns and minors (1), and up to rooks (2)
+        std::array<std::array<BitBoard, 3>, 2> m_threats;
     };
 
 }
@@ -1,9 +1,13 @@
 #include "engine.h"
 #include "commons/utils.h"
 #include "core/perft.h"
+#include "eval/nnue/nnue.h"
 #include "search/params.h"
+#include "tb/tablebase.h"
+#include "tb/tbgen.h"
 #ifdef EXTERNAL_TUNE
     #include "eval/hce/tuner/tuner.h"
+    #include "eval/nnue/trainer/trainer.h"
 #endif
 
 namespace sagittar {
@@ -13,8 +17,9 @@ namespace sagittar {
         Position::initialize();
         search::params::init();
         key_history.reserve(1024);
-        key_history.shrink_to_fit();
-        key_history.clear();
+        // Search with the embedded network, when the build has one
+        use_nnue = eval::nnue::loadEmbeddedNetwork();
+        searcher.setUseNNUE(use_nnue);
     }
 
     Engine::~Engine() {}
@@ -24,15 +29,11 @@ namespace sagittar {
     void Engine::reset() {
         pos.reset();
         searcher.reset();
-        key_history.reserve(1024);
-        key_history.shrink_to_fit();
         key_history.clear();
     }
 
     void Engine::resetForSearch() {
         searcher.resetForSearch();
-        key_history.reserve(1024);
-        key_history.shrink_to_fit();
         key_history.clear();
     }
 
@@ -42,6 +43,54 @@ namespace sagittar {
 
     void Engine::setThreadCount(const std::size_t n) { searcher.setThreadCount(n); }
 
+    void Engine::setEvalCacheSize(const std::size_t mb) { searcher.setEvalCacheSize(mb); }
+
+    bool Engine::setEvalFile(const std::string& path) {
+        const bool loaded = eval::nnue::loadNetwork(path);
+        if (loaded)
+        {
+            // Cached evaluations may come from the previous network
+            searcher.clearEvalCaches();
+        }
+        return loaded;
+    }
+
+    bool Engine::setUseNNUE(const bool enable) {
+        if (enable && !eval::nnue::isLoaded())
+        {
+            return false;
+        }
+        use_nnue = enable;
+        searcher.setUseNNUE(enable);
+        return true;
+    }
+
+    bool Engine::usesNNUE() const { return use_nnue; }
+
+    std::size_t Engine::setTablebasePath(const std::string& path) {
+        // Nothing to load from the default, the tables loaded before are dropped all the same
+        return tb::load((path == "<empty>") ? "" : path);
+    }
+
+    bool Engine::generateTablebases(const std::string&              dir,
+                                    const std::vector<std::string>& materials) {
+        // A number stands for every material of that many pieces
+        std::vector<std::string> codes;
+        for (const std::string& material : materials)
+        {
+            if (std::all_of(material.begin(), material.end(), ::isdigit))
+            {
+                const std::vector<std::string> all = tb::materialsUpTo(std::stoi(material));
+                codes.insert(codes.end(), all.begin(), all.end());
+            }
+            else
+            {
+                codes.push_back(material);
+            }
+        }
+        return tb::generate(codes, dir);
+    }
+
     void Engine::setPosition(std::string fen) { pos.setFen(fen); }
 
     bool Engine::doMove(const std::string& move) {
@@ -165,6 +214,12 @@ namespace sagittar {
         eval::hce::tuner::TunerSettings default_settings{};
         eval::hce::tuner::tune(epd_path, default_settings);
     }
+
+    void Engine::train(const std::filesystem::path& epd_path,
+                       const std::filesystem::path& out_path) {
+        eval::nnue::trainer::TrainerSettings default_settings{};
+        eval::nnue::trainer::train(epd_path, out_path, default_settings);
+    }
 #endif
 
     void Engine::display() const { pos.display(); }
@@ -15,6 +15,7 @@ namespace sagittar {
         Position         pos;
         search::Searcher searcher;
         std::vector<u64> key_history;
+        bool             use_nnue;
 
        public:
         Engine();
@@ -31,6 +32,18 @@ namespace sagittar {
 
         void setThreadCount(const std::size_t);
 
+        void setEvalCacheSize(const std::size_t);
+
+        bool setEvalFile(const std::string&);
+
+        bool setUseNNUE(const bool);
+
+        bool usesNNUE() const;
+
+        std::size_t setTablebasePath(const std::string&);
+
+        bool generateTablebases(const std::string& dir, const std::vector<std::string>& materials);
+
         void setPosition(std::string);
 
         bool doMove(const std::string&);
@@ -50,6 +63,8 @@ namespace sagittar {
 
 #ifdef EXTERNAL_TUNE
         void tune(const std::filesystem::path& epd_path);
+
+        void train(const std::filesystem::path& epd_path, const std::filesystem::path& out_path);
 #endif
 
         void display() const;
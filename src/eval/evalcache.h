@@ -0,0 +1,67 @@
+#pragma once
+
+#include "commons/pch.h"
+#include "core/types.h"
+
+namespace sagittar::eval {
+
+    constexpr std::size_t DEFAULT_EVAL_CACHE_SIZE_MB = 1;
+
+    // Static evaluations by position key. Every search thread owns one, so entries are read and
+    // written without synchronization. An entry packs the upper 48 bits of the key with the
+    // evaluation in 8 bytes.
+    class EvalCache {
+       public:
+        explicit EvalCache(const std::size_t mb = 0) { setSize(mb); }
+
+        // Allocates and zeroes the entries, from the calling thread. A size of 0 disables the
+        // cache.
+        void setSize(const std::size_t mb) {
+            size_mb = mb;
+            entries.clear();
+            entries.shrink_to_fit();
+            entries.resize((mb * 0x100000) / sizeof(u64));
+        }
+
+        [[nodiscard]] std::size_t getSize() const { return size_mb; }
+
+        void clear() { std::fill(entries.begin(), entries.end(), 0ULL); }
+
+        [[nodiscard]] inline bool probe(const u64 key, Score* eval) const {
+            if (entries.empty())
+            {
+                return false;
+            }
+            const u64 data = entries[getIndex(key)];
+            if ((data & KEY_MASK) != (key & KEY_MASK))
+            {
+                return false;
+            }
+            *eval = static_cast<i16>(data & EVAL_MASK);
+            return true;
+        }
+
+        inline void store(const u64 key, const Score eval) {
+            if (entries.empty())
+            {
+                return;
+            }
+            assert(eval >= std::numeric_limits<i16>::min());
+            assert(eval <= std::numeric_limits<i16>::max());
+            entries[getIndex(key)] = (key & KEY_MASK) | static_cast<u16>(eval);
+        }
+
+       private:
+        static constexpr u64 EVAL_MASK = 0xFFFFULL;
+        static constexpr u64 KEY_MASK  = ~EVAL_MASK;
+
+        [[nodiscard]] inline u64 getIndex(const u64 key) const {
+            return static_cast<u64>((static_cast<u128>(key) * static_cast<u128>(entries.size()))
+                                    >> 64);
+        }
+
+        std::vector<u64> entries;
+        std::size_t      size_mb{0};
+    };
+
+}
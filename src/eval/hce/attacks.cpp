@@ -0,0 +1,175 @@
+#include "attacks.h"
+#include "core/movegen.h"
+#include "eval/hce/defs.h"
+
+namespace sagittar::eval::hce {
+
+    namespace {
+
+        constexpr BitBoard ALL_SQUARES_BB(~0ULL);
+
+        // Files C to F, on each side's 2nd to 4th ranks
+        constexpr std::array<BitBoard, 2> SPACE_AREA = {
+          (FILE_C_BB | FILE_D_BB | FILE_E_BB | FILE_F_BB) & (RANK_2_BB | RANK_3_BB | RANK_4_BB),
+          (FILE_C_BB | FILE_D_BB | FILE_E_BB | FILE_F_BB) & (RANK_5_BB | RANK_6_BB | RANK_7_BB),
+        };
+
+        template<PieceType PT>
+        constexpr i32 mobilityScore(const int n) {
+            if constexpr (PT == PieceType::KNIGHT)
+            {
+                return MOBILITY_KNIGHT[n];
+            }
+            else if constexpr (PT == PieceType::BISHOP)
+            {
+                return MOBILITY_BISHOP[n];
+            }
+            else if constexpr (PT == PieceType::ROOK)
+            {
+                return MOBILITY_ROOK[n];
+            }
+            else
+            {
+                return MOBILITY_QUEEN[n];
+            }
+        }
+
+        template<Color US, PieceType PT, typename Trace>
+        i32 evaluatePieceType(const Position& pos,
+                              AttackInfo&     ai,
+                              const BitBoard  mobility_area,
+                              Trace&          trace) {
+            constexpr Color THEM = colorFlip(US);
+
+            const BitBoard occupancy =
+              (PT == PieceType::KNIGHT) ? ALL_SQUARES_BB : pos.occupied();
+
+            i32 score = 0;
+
+            BitBoard bb = pos.pieces(US, PT);
+            while (bb)
+            {
+                const Square   sq      = static_cast<Square>(bb.pop_lsb());
+                const BitBoard attacks = sagittar::attacks<PT>(sq, occupancy);
+
+                ai.by_type[US][PT] |= attacks;
+
+                const int mobility  = (attacks & mobility_area).count();
+                const int zone_hits = (attacks & ai.king_zone[THEM]).count();
+
+                score += mobilityScore<PT>(mobility);
+                score += KING_ZONE_ATTACK[PT] * zone_hits;
+
+                if constexpr (Trace::ENABLED)
+                {
+                    trace.mobility[PT - PieceType::KNIGHT][mobility][US]++;
+                    trace.king_zone_attack[PT][US] += zone_hits;
+                }
+            }
+
+            ai.all[US] |= ai.by_type[US][PT];
+
+            return score;
+        }
+
+        template<Color US, typename Trace>
+        i32 evaluateThreats(const Position& pos, const AttackInfo& ai, Trace& trace) {
+            constexpr Color THEM = colorFlip(US);
+
+            const BitBoard targets = pos.pieces(THEM) & ~pos.pieces(THEM, PieceType::KING);
+            const BitBoard by_minor =
+              ai.by_type[US][PieceType::KNIGHT] | ai.by_type[US][PieceType::BISHOP];
+
+            i32 score = 0;
+
+            for (int pt = PieceType::PAWN; pt < PieceType::KING; pt++)
+            {
+                const BitBoard victims = targets & pos.pieces(static_cast<PieceType>(pt));
+
+                const int by_pawn = (victims & ai.by_type[US][PieceType::PAWN]).count();
+                const int by_min  = (victims & by_minor).count();
+                const int by_rook = (victims & ai.by_type[US][PieceType::ROOK]).count();
+
+                score += THREAT_BY_PAWN[pt] * by_pawn;
+                score += THREAT_BY_MINOR[pt] * by_min;
+                score += THREAT_BY_ROOK[pt] * by_rook;
+
+                if constexpr (Trace::ENABLED)
+                {
+                    trace.threat_by_pawn[pt][US] += by_pawn;
+                    trace.threat_by_minor[pt][US] += by_min;
+                    trace.threat_by_rook[pt][US] += by_rook;
+                }
+            }
+
+            const int space = (SPACE_AREA[US] & ~pos.pieces(US, PieceType::PAWN)
+                               & ~ai.by_type[THEM][PieceType::PAWN])
+                                .count();
+            score += SPACE * space;
+            if constexpr (Trace::ENABLED)
+            {
+                trace.space[US] += space;
+            }
+
+            return score;
+        }
+
+        template<Color US, typename Trace>
+        i32 evaluatePieces(const Position&  pos,
+                           const PawnEntry& pawns,
+                           AttackInfo&      ai,
+                           Trace&           trace) {
+            constexpr Color THEM = colorFlip(US);
+
+            const BitBoard mobility_area =
+              ~(pos.pieces(US, PieceType::PAWN, PieceType::KING) | pawns.attacks[THEM]);
+
+            const int pawn_zone_hits = (pawns.attacks[US] & ai.king_zone[THEM]).count();
+
+            i32 score = KING_ZONE_ATTACK[PieceType::PAWN] * pawn_zone_hits;
+            if constexpr (Trace::ENABLED)
+            {
+                trace.king_zone_attack[PieceType::PAWN][US] += pawn_zone_hits;
+            }
+
+            score += evaluatePieceType<US, PieceType::KNIGHT>(pos, ai, mobility_area, trace);
+            score += evaluatePieceType<US, PieceType::BISHOP>(pos, ai, mobility_area, trace);
+            score += evaluatePieceType<US, PieceType::ROOK>(pos, ai, mobility_area, trace);
+            score += evaluatePieceType<US, PieceType::QUEEN>(pos, ai, mobility_area, trace);
+
+            return score;
+        }
+
+    }
+
+    template<typename Trace>
+    i32 evaluateAttacks(const Position&  pos,
+                        const PawnEntry& pawns,
+                        AttackInfo&      ai,
+                        Trace&           trace) {
+        for (const Color c : {Color::WHITE, Color::BLACK})
+        {
+            const auto     ksq  = static_cast<Square>(pos.pieces(c, PieceType::KING).lsb());
+            const BitBoard king = attacks<PieceType::KING>(ksq, ALL_SQUARES_BB);
+
+            ai.by_type[c][PieceType::PAWN] = pawns.attacks[c];
+            ai.by_type[c][PieceType::KING] = king;
+            ai.all[c]                      = pawns.attacks[c] | king;
+            ai.king_zone[c]                = king | BB(ksq);
+        }
+
+        i32 score = evaluatePieces<Color::WHITE>(pos, pawns, ai, trace)
+                  - evaluatePieces<Color::BLACK>(pos, pawns, ai, trace);
+
+        // Once the attacks of both sides are known
+        score += evaluateThreats<Color::WHITE>(pos, ai, trace);
+        score -= evaluateThreats<Color::BLACK>(pos, ai, trace);
+
+        return score;
+    }
+
+    template i32 evaluateAttacks<NoTrace>(const Position&, const PawnEntry&, AttackInfo&, NoTrace&);
+    template i32
+    evaluateAttacks<EvalTrace>(const Position&, const PawnEntry&, AttackInfo&, EvalTrace&);
+
+}
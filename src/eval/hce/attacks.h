@@ -0,0 +1,23 @@
+#pragma once
+
+#include "commons/pch.h"
+#include "core/bitboard.h"
+#include "core/position.h"
+#include "core/types.h"
+#include "eval/hce/pawns.h"
+#include "eval/hce/trace.h"
+
+namespace sagittar::eval::hce {
+
+    // Squares attacked by each side, gathered in a single pass over the pieces
+    struct AttackInfo {
+        std::array<std::array<BitBoard, 6>, 2> by_type{};  // [color][piece type]
+        std::array<BitBoard, 2>                all{};
+        std::array<BitBoard, 2>                king_zone{};  // Around each color's king
+    };
+
+    // Mobility, king zone attacks, threats and space. Packed, from white's point of view.
+    template<typename Trace>
+    i32 evaluateAttacks(const Position&, const PawnEntry&, AttackInfo&, Trace&);
+
+}
@@ -1,23 +1,26 @@
 #pragma once
 
 #include "commons/pch.h"
+#include "core/psqt.h"
 #include "core/types.h"
 
 namespace sagittar::eval::hce {
 
+    using sagittar::eg_score;
+    using sagittar::mg_score;
+    using sagittar::PHASE_WEIGHTS;
+    using sagittar::PIECE_SCORES;
+    using sagittar::PIECE_SQUARE_SCORES;
+    using sagittar::PSQT;
+    using sagittar::PSQT_SCORES;
+    using sagittar::S;
+
     enum GamePhase : u8 {
         MG,
         EG
     };
 
-    constexpr std::array<i32, 6> PHASE_WEIGHTS = {0, 1, 1, 2, 4, 0};
-    constexpr i32                TOTAL_PHASE   = 24;
-
-    constexpr i32 S(const i32 mg, const i32 eg) {
-        return static_cast<i32>(static_cast<u32>(eg) << 16) + mg;
-    }
-    constexpr i32 mg_score(const i32 score) { return static_cast<i16>(score); }
-    constexpr i32 eg_score(const i32 score) { return static_cast<i16>((score + 0x8000) >> 16); }
+    constexpr i32 TOTAL_PHASE = 24;
 
     constexpr Score scale_eval(const Score mg, const Score eg, const i32 phase) {
         return static_cast<Score>(((mg * (256 - phase)) + (eg * phase)) / 256);
@@ -40,91 +43,69 @@ namespace sagittar::eval::hce {
         return phase;
     }
 
-    // https://www.chessprogramming.org/PeSTO%27s_Evaluation_Function
-    // clang-format off
-    constexpr std::array<i32, 6> PIECE_SCORES = {
-        S(82, 94),      // PAWN
-        S(337, 281),    // KNIGHT
-        S(365, 297),    // BISHOP
-        S(477, 512),    // ROOK
-        S(1025, 936),   // QUEEN
-        0               // KING
+    constexpr i32 TEMPO_BONUS       = S(15, 3);
+    constexpr i32 BISHOP_PAIR_BONUS = S(25, 50);
+
+    // Pawn structure, by relative rank where indexed
+    constexpr std::array<i32, 8> PASSED_PAWN = {
+        S(0, 0), S(0, 5), S(-5, 10), S(0, 20), S(10, 40), S(25, 75), S(45, 120), S(0, 0),
+    };
+    constexpr std::array<i32, 8> CONNECTED_PAWN = {
+        S(0, 0), S(4, 2), S(6, 4), S(10, 8), S(18, 16), S(30, 30), S(45, 45), S(0, 0),
+    };
+    constexpr i32 ISOLATED_PAWN = S(-8, -10);
+    constexpr i32 DOUBLED_PAWN  = S(-8, -20);
+    constexpr i32 BACKWARD_PAWN = S(-6, -8);
+
+    // King shelter, on the king's file and the two next to it. Indexed by the relative rank of
+    // the rearmost own pawn and of the closest enemy pawn on each file, 0 when there is none.
+    constexpr std::array<i32, 8> PAWN_SHIELD = {
+        S(-24, 0), S(12, 0), S(6, 0), S(-6, 0), S(-14, 0), S(-18, 0), S(-20, 0), S(0, 0),
+    };
+    constexpr std::array<i32, 8> PAWN_STORM = {
+        S(0, 0), S(-10, 0), S(-25, 0), S(-12, 0), S(-6, 0), S(-2, 0), S(0, 0), S(0, 0),
     };
 
-    using PSQT = std::array<i32, 64>;
-
-    constexpr std::array<PSQT, 6> PSQT_SCORES = []() {
-        std::array<PSQT, 6> table{};
-
-        table[PieceType::PAWN] = {
-            S(0, 0),     S(0, 0),      S(0, 0),     S(0, 0),     S(0, 0),     S(0, 0),     S(0, 0),     S(0, 0),
-            S(98, 178),  S(134, 173),  S(61, 158),  S(95, 134),  S(68, 147) , S(126, 132), S(34, 165),  S(-11, 187),
-            S(-6, 94),   S(7, 100),    S(26, 85),   S(31, 67),   S(65, 56),   S(56, 53),   S(25, 82),   S(-20, 84),
-            S(-14, 32),  S(13, 24),    S(6, 13),    S(21, 5),    S(23, -2),   S(12, 4),    S(17, 17),   S(-23, 17),
-            S(-27, 13),  S(-2, 9),     S(-5, -3),   S(12, -7),   S(17, -7),   S(6, -8),    S(10, 3),    S(-25, -1),
-            S(-26, 4),   S(-4, 7),     S(-4, -6),   S(-10, 1),   S(3, 0),     S(3, -5),    S(33, -1),   S(-12, -8),
-            S(-35, 13),  S(-1, 8),     S(-20, 8),   S(-23, 10),  S(-15, 13),  S(24, 0),    S(38, 2),    S(-22, -7),
-            S(0, 0),     S(0, 0),      S(0, 0),     S(0, 0),     S(0, 0),     S(0, 0),     S(0, 0),     S(0, 0)
-        };
-
-        table[PieceType::KNIGHT] = {
-            S(-167, -58), S(-89, -38), S(-34, -13), S(-49, -28), S(61, -31),  S(-97, -27), S(-15, -63), S(-107, -99),
-            S(-73, -25),  S(-41, -8),  S(72, -25),  S(36, -2),   S(23, -9),   S(62, -25),  S(7, -24),   S(-17, -52),
-            S(-47, -24),  S(60, -20),  S(37, 10),   S(65, 9),    S(84, -1),   S(129, -9),  S(73, -19),  S(44, -41),
-            S(-9, -17),   S(17, 3),    S(19, 22),   S(53, 22),   S(37, 22),   S(69, 11),   S(18, 8),    S(22, -18),
-            S(-13, -18),  S(4, -6),    S(16, 16),   S(13, 25),   S(28, 16),   S(19, 17),   S(21, 4),    S(-8, -18),
-            S(-23, -23),  S(-9, -3),   S(12, -1),   S(10, 15),   S(19, 10),   S(17, -3),   S(25, -20),  S(-16, -22),
-            S(-29, -42),  S(-53, -20), S(-12, -10), S(-3, -5),   S(-1, -2),   S(18, -20),  S(-14, -23), S(-19, -44),
-            S(-105, -29), S(-21, -51), S(-58, -23), S(-33, -15), S(-17, -22), S(-28, -18), S(-19, -50), S(-23, -64)
-        };
-
-        table[PieceType::BISHOP] = {
-            S(-29, -14),  S(4, -21),   S(-82, -11), S(-37, -8),  S(-25, -7),  S(-42, -9),  S(7, -17),   S(-8, -24),
-            S(-26, -8),   S(16, -4),   S(-18, 7),   S(-13, -12), S(30, -3),   S(59, -13),  S(18, -4),   S(-47, -14),
-            S(-16, 2),    S(37, -8),   S(43, 0),    S(40, -1),   S(35, -2),   S(50, 6),    S(37, 0),    S(-2, 4),
-            S(-4, -3),    S(5, 9),     S(19, 12),   S(50, 9),    S(37, 14),   S(37, 10),   S(7, 3),     S(-2, 2),
-            S(-6, -6),    S(13, 3),    S(13, 13),   S(26, 19),   S(34, 7),    S(12, 10),   S(10, -3),   S(4, -9),
-            S(0, -12),    S(15, -3),   S(15, 8),    S(15, 10),   S(14, 13),   S(27, 3),    S(18, -7),   S(10, -15),
-            S(4, -14),    S(15, -18),  S(16, -7),   S(0, -1),    S(7, 4),     S(21, -9),   S(33, -15),  S(1, -27),
-            S(-33, -23),  S(-3, -9),   S(-14, -23), S(-21, -5),  S(-13, -9),  S(-12, -16), S(-39, -5),  S(-21, -17)
-        };
-
-        table[PieceType::ROOK] = {
-            S(32, 13),    S(42, 10),   S(32, 18),   S(51, 15),   S(63, 12),   S(9, 12),    S(31, 8),    S(43, 5),
-            S(27, 11),    S(32, 13),   S(58, 13),   S(62, 11),   S(80, -3),   S(67, 3),    S(26, 8),    S(44, 3),
-            S(-5, 7),     S(19, 7),    S(26, 7),    S(36, 5),    S(17, 4),    S(45, -3),   S(61, -5),   S(16, -3),
-            S(-24, 4),    S(-11, 3),   S(7, 13),    S(26, 1),    S(24, 2),    S(35, 1),    S(-8, -1),   S(-20, 2),
-            S(-36, 3),    S(-26, 5),   S(-12, 8),   S(-1, 4),    S(9, -5),    S(-7, -6),   S(6, -8),    S(-23, -11),
-            S(-45, -4),   S(-25, 0),   S(-16, -5),  S(-17, -1),  S(3, -7),    S(0, -12),   S(-5, -8),   S(-33, -16),
-            S(-44, -6),   S(-16, -6),  S(-20, 0),   S(-9, 2),    S(-1, -9),   S(11, -9),   S(-6, -11),  S(-71, -3),
-            S(-19, -9),   S(-13, 2),   S(1, 3),     S(17, -1),   S(16, -5),   S(7, -13),   S(-37, 4),   S(-26, -20)
-        };
-
-        table[PieceType::QUEEN] = {
-            S(-28, -9),   S(0, 22),    S(29, 22),   S(12, 27),   S(59, 27),   S(44, 19),   S(43, 10),   S(45, 20),
-            S(-24, -17),  S(-39, 20),  S(-5, 32),   S(1, 41),    S(-16, 58),  S(57, 25),   S(28, 30),   S(54, 0),
-            S(-13, -20),  S(-17, 6),   S(7, 9),     S(8, 49),    S(29, 47),   S(56, 35),   S(47, 19),   S(57, 9),
-            S(-27, 3),    S(-27, 22),  S(-16, 24),  S(-16, 45),  S(-1, 57),   S(17, 40),   S(-2, 57),   S(1, 36),
-            S(-9, -18),   S(-26, 28),  S(-9, 19),   S(-10, 47),  S(-2, 31),   S(-4, 34),   S(3, 39),    S(-3, 23),
-            S(-14, -16),  S(2, -27),   S(-11, 15),  S(-2, 6),    S(-5, 9),    S(2, 17),    S(14, 10),   S(5, 5),
-            S(-35, -22),  S(-8, -23),  S(11, -30),  S(2, -16),   S(8, -16),   S(15, -23),  S(-3, -36),  S(1, -32),
-            S(-1, -33),   S(-18, -28), S(-9, -22),  S(10, -43),  S(-15, -5),  S(-25, -32), S(-31, -20), S(-50, -41)
-        };
-
-        table[PieceType::KING] = {
-            S(-65, -74),  S(23, -35),  S(16, -18),  S(-15, -18), S(-56, -11), S(-34, 15),  S(2, 4),     S(13, -17),
-            S(29, -12),   S(-1, 17),   S(-20, 14),  S(-7, 17),   S(-8, 17),   S(-4, 38),   S(-38, 23),  S(-29, 11),
-            S(-9, 10),    S(24, 17),   S(2, 23),    S(-16, 15),  S(-20, 20),  S(6, 45),    S(22, 44),   S(-22, 13),
-            S(-17, -8),   S(-20, 22),  S(-12, 24),  S(-27, 27),  S(-30, 26),  S(-25, 33),  S(-14, 26),  S(-36, 3),
-            S(-49, -18),  S(-1, -4),   S(-27, 21),  S(-39, 24),  S(-46, 27),  S(-44, 23),  S(-33, 9),   S(-51, -11),
-            S(-14, -19),  S(-14, -3),  S(-22, 11),  S(-46, 21),  S(-44, 23),  S(-30, 16),  S(-15, 7),   S(-27, -9),
-            S(1, -27),    S(7, -11),   S(-8, 4),    S(-64, 13),  S(-43, 14),  S(-16, 4),   S(9, -5),    S(8, -17),
-            S(-15, -53),  S(36, -34),  S(12, -21),  S(-54, -11), S(8, -28),  S(-28, -14),  S(24, -24),  S(14, -43)
-        };
-
-        return table;
-    }();
+    // Mobility, by the number of attacked squares not occupied by own pawns or king, nor attacked
+    // by enemy pawns
+    // clang-format off
+    constexpr std::array<i32, 9> MOBILITY_KNIGHT = {
+        S(-30, -40), S(-11, -19), S(-2, -10), S(4, -3), S(9, 2), S(13, 7), S(18, 12),
+        S(21, 16), S(25, 20),
+    };
+    constexpr std::array<i32, 14> MOBILITY_BISHOP = {
+        S(-25, -40), S(-6, -15), S(2, -5), S(9, 3), S(14, 10), S(18, 16), S(23, 21),
+        S(26, 26), S(30, 31), S(33, 35), S(36, 39), S(39, 43), S(42, 46), S(45, 50),
+    };
+    constexpr std::array<i32, 15> MOBILITY_ROOK = {
+        S(-20, -35), S(-5, -10), S(1, 1), S(5, 9), S(9, 16), S(13, 22), S(16, 27),
+        S(19, 32), S(22, 37), S(24, 41), S(26, 45), S(29, 49), S(31, 53), S(33, 57),
+        S(35, 60),
+    };
+    constexpr std::array<i32, 28> MOBILITY_QUEEN = {
+        S(-15, -30), S(-4, -11), S(0, -3), S(3, 3), S(6, 8), S(9, 13), S(11, 17),
+        S(13, 21), S(15, 24), S(17, 28), S(18, 31), S(20, 34), S(22, 37), S(23, 39),
+        S(25, 42), S(26, 45), S(27, 47), S(29, 49), S(30, 52), S(31, 54), S(32, 56),
+        S(34, 58), S(35, 60), S(36, 62), S(37, 64), S(38, 66), S(39, 68), S(40, 70),
+    };
     // clang-format on
 
-    constexpr i32 TEMPO_BONUS = S(15, 3);
+    // Per square of the enemy king zone attacked, by attacker
+    constexpr std::array<i32, 6> KING_ZONE_ATTACK = {
+        S(2, 0), S(8, 0), S(6, 0), S(8, 0), S(12, 0), S(0, 0),
+    };
+
+    // Per enemy piece attacked, by victim
+    constexpr std::array<i32, 6> THREAT_BY_PAWN = {
+        S(0, 0), S(40, 30), S(40, 30), S(55, 25), S(55, 20), S(0, 0),
+    };
+    constexpr std::array<i32, 6> THREAT_BY_MINOR = {
+        S(3, 15), S(15, 20), S(20, 20), S(35, 30), S(30, 40), S(0, 0),
+    };
+    constexpr std::array<i32, 6> THREAT_BY_ROOK = {
+        S(2, 15), S(15, 25), S(15, 25), S(0, 15), S(40, 30), S(0, 0),
+    };
+
+    // Per central square on our side of the board not attacked by enemy pawns
+    constexpr i32 SPACE = S(2, 0);
 }
@@ -0,0 +1,151 @@
+#include "endgame.h"
+#include "eval/hce/kpk.h"
+#include <unordered_map>
+
+namespace sagittar::eval::hce {
+
+    namespace {
+
+        constexpr i32 distance(const Square a, const Square b) {
+            return std::max(std::abs(sq2rank(a) - sq2rank(b)), std::abs(sq2file(a) - sq2file(b)));
+        }
+
+        constexpr i32 manhattanDistance(const Square a, const Square b) {
+            return std::abs(sq2rank(a) - sq2rank(b)) + std::abs(sq2file(a) - sq2file(b));
+        }
+
+        constexpr i32 edgeDistance(const Square sq) {
+            const i32 rank = sq2rank(sq);
+            const i32 file = sq2file(sq);
+            return std::min({rank, 7 - rank, file, 7 - file});
+        }
+
+        constexpr bool isDarkSquare(const Square sq) {
+            return ((static_cast<i32>(sq2rank(sq)) + sq2file(sq)) & 1) == 0;
+        }
+
+        // Drive the lone king to the edge, and the strong king towards it
+        constexpr i32 pushToEdge(const Square sq) { return 20 * (3 - edgeDistance(sq)); }
+        constexpr i32 pushClose(const Square a, const Square b) {
+            return 10 * (7 - distance(a, b));
+        }
+
+        inline Square kingSq(const Position& pos, const Color c) {
+            return static_cast<Square>(pos.pieces(c, PieceType::KING).lsb());
+        }
+
+        // Neither side can force mate
+        Score evaluateDraw(const Position&, const Color) { return 0; }
+
+        // KRK, KQK
+        Score evaluateKXK(const Position& pos, const Color strong) {
+            const Square strong_ksq = kingSq(pos, strong);
+            const Square weak_ksq   = kingSq(pos, colorFlip(strong));
+            return KNOWN_WIN + pushToEdge(weak_ksq) + pushClose(strong_ksq, weak_ksq);
+        }
+
+        // Mate is only forced in a corner of the bishop's color
+        Score evaluateKBNK(const Position& pos, const Color strong) {
+            const Square strong_ksq = kingSq(pos, strong);
+            const Square weak_ksq   = kingSq(pos, colorFlip(strong));
+            const Square bishop_sq  = static_cast<Square>(pos.pieces(PieceType::BISHOP).lsb());
+
+            const i32 corner_distance =
+              isDarkSquare(bishop_sq) ? std::min(manhattanDistance(weak_ksq, Square::A1),
+                                                 manhattanDistance(weak_ksq, Square::H8))
+                                      : std::min(manhattanDistance(weak_ksq, Square::A8),
+                                                 manhattanDistance(weak_ksq, Square::H1));
+
+            return KNOWN_WIN + (10 * (14 - corner_distance)) + pushClose(strong_ksq, weak_ksq);
+        }
+
+        // Exact from the bitbase. A win is worth less than a promotion, and more the further the
+        // pawn has come.
+        Score evaluateKPK(const Position& pos, const Color strong) {
+            // Seen from the strong side, the pawn moving up the board
+            const u8     flip       = (strong == Color::WHITE) ? 0 : 56;
+            const Square pawn_sq    = static_cast<Square>(pos.pieces(PieceType::PAWN).lsb() ^ flip);
+            const Square strong_ksq = static_cast<Square>(kingSq(pos, strong) ^ flip);
+            const Square weak_ksq   = static_cast<Square>(kingSq(pos, colorFlip(strong)) ^ flip);
+            const Color  stm        = (pos.stm() == strong) ? Color::WHITE : Color::BLACK;
+
+            if (!kpk::probe(strong_ksq, pawn_sq, weak_ksq, stm))
+            {
+                return 0;
+            }
+
+            return KNOWN_WIN - (100 * (Rank::RANK_8 - sq2rank(pawn_sq)))
+                 - distance(strong_ksq, pawn_sq);
+        }
+
+        // Material key of code, e.g. "KBNK" for king, bishop and knight against a lone king
+        u64 materialKey(const std::string& code, const Color strong) {
+            const std::size_t split = code.find('K', 1);
+
+            std::string strong_pieces = code.substr(0, split);
+            std::string weak_pieces   = code.substr(split);
+
+            std::string& black = (strong == Color::WHITE) ? weak_pieces : strong_pieces;
+            std::transform(black.begin(), black.end(), black.begin(), ::tolower);
+
+            const std::string& white = (strong == Color::WHITE) ? strong_pieces : weak_pieces;
+
+            const std::string fen = "8/" + black + std::to_string(8 - black.size()) + "/8/8/8/8/"
+                                  + white + std::to_string(8 - white.size()) + "/8 w - - 0 1";
+
+            Position pos;
+            pos.setFen(fen);
+            return pos.material_key();
+        }
+
+        struct Registry {
+            std::unordered_map<u64, Endgame> evaluators;
+
+            Registry() {
+                for (const Color strong : {Color::WHITE, Color::BLACK})
+                {
+                    for (const auto* code : {"KK", "KNK", "KBK", "KNNK", "KNKN", "KBKB", "KBKN"})
+                    {
+                        evaluators[materialKey(code, strong)] = {evaluateDraw, strong};
+                    }
+
+                    evaluators[materialKey("KRK", strong)]  = {evaluateKXK, strong};
+                    evaluators[materialKey("KQK", strong)]  = {evaluateKXK, strong};
+                    evaluators[materialKey("KBNK", strong)] = {evaluateKBNK, strong};
+                    evaluators[materialKey("KPK", strong)]  = {evaluateKPK, strong, true};
+                }
+            }
+        };
+
+        // Built on first use, after the zobrist keys
+        const Registry& registry() {
+            static const Registry instance;
+            return instance;
+        }
+
+    }
+
+    Endgame probeEvaluator(const u64 material_key) {
+        const auto& evaluators = registry().evaluators;
+        const auto  it         = evaluators.find(material_key);
+        return (it == evaluators.end()) ? Endgame{} : it->second;
+    }
+
+    u8 scaleOppositeBishops(const Position& pos, const Color strong) {
+        const Square white_bishop =
+          static_cast<Square>(pos.pieces(Color::WHITE, PieceType::BISHOP).lsb());
+        const Square black_bishop =
+          static_cast<Square>(pos.pieces(Color::BLACK, PieceType::BISHOP).lsb());
+
+        if (isDarkSquare(white_bishop) == isDarkSquare(black_bishop))
+        {
+            return SCALE_NORMAL;
+        }
+
+        // Even a pawn or two up is often not enough
+        const i32 pawns_up = pos.pieceCount(pieceCreate(PieceType::PAWN, strong))
+                           - pos.pieceCount(pieceCreate(PieceType::PAWN, colorFlip(strong)));
+        return static_cast<u8>(std::clamp<i32>(16 + (8 * pawns_up), 16, SCALE_NORMAL));
+    }
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "commons/pch.h"
+#include "core/position.h"
+#include "core/types.h"
+
+namespace sagittar::eval::hce {
+
+    // Scale factors apply to the endgame part of the eval, out of SCALE_NORMAL
+    constexpr u8 SCALE_DRAW   = 0;
+    constexpr u8 SCALE_NORMAL = 64;
+
+    // Above any material advantage, below the search's win scores
+    constexpr Score KNOWN_WIN = 10000;
+
+    // Exact eval of a recognized endgame, from the strong side's point of view
+    using EndgameEvaluator = Score (*)(const Position&, const Color strong);
+
+    // Scale factor for the strong side's advantage in a recognized endgame
+    using EndgameScaler = u8 (*)(const Position&, const Color strong);
+
+    struct Endgame {
+        EndgameEvaluator fn{nullptr};
+        Color            strong{Color::WHITE};
+        bool             exact{false};  // Known win or draw, searching deeper cannot help
+    };
+
+    // Looked up by material key, fn is null when the material is not recognized
+    Endgame probeEvaluator(const u64 material_key);
+
+    // For one bishop each and pawns, whatever the pawn count
+    u8 scaleOppositeBishops(const Position&, const Color strong);
+
+}
@@ -6,168 +6,147 @@ namespace sagittar::eval::hce {
 
     namespace {
 
-        constexpr std::array<std::array<PSQT, 2>, 6> psqt_b = []() {
-            std::array<std::array<PSQT, 2>, 6> table{};
-
-            for (int pt = PieceType::PAWN; pt <= PieceType::KING; pt++)
+        // Material and PSQT come from Position, this only records their coefficients
+        void tracePsqt(const Position& pos, EvalTrace& trace) {
+            for (int sq = Square::A1; sq <= Square::H8; sq++)
             {
-                for (int sq = Square::A1; sq <= Square::H8; sq++)
+                const Piece p = pos.pieceOn(static_cast<Square>(sq));
+
+                if (p == Piece::NO_PIECE)
                 {
-                    table[pt][MG][sq] = mg_score(PIECE_SCORES[pt]) + mg_score(PSQT_SCORES[pt][sq]);
-                    table[pt][EG][sq] = eg_score(PIECE_SCORES[pt]) + eg_score(PSQT_SCORES[pt][sq]);
+                    continue;
                 }
+
+                const PieceType pt = pieceTypeOf(p);
+                const Color     c  = pieceColorOf(p);
+
+                trace.piece_counts[pt][c]++;
+                trace.psq_counts[pt][(c == Color::WHITE) ? SQUARES_MIRRORED[sq] : sq][c]++;
             }
+        }
 
-            return table;
-        }();
+        // Blends a packed, white relative score into a score for the side to move
+        template<Color US>
+        Score blend(const Position& pos, const MaterialEntry& material, const i32 score) {
+            const i32 phase = material.phase;
+#ifdef DEBUG
+            assert(phase == std_phase(TOTAL_PHASE - pos.phase()));
+#endif
+
+            const Color strong = (eg_score(score) > 0) ? Color::WHITE : Color::BLACK;
+            const u8    sf     = material.scaleFactor(pos, strong);
+            const Score mg     = mg_score(score);
+            const Score eg     = eg_score(score) * sf / SCALE_NORMAL;
 
-        constexpr std::array<std::array<PSQT, 2>, 6> psqt_w = []() {
-            std::array<std::array<PSQT, 2>, 6> table{};
+            Score eval = scale_eval(mg, eg, phase);
 
-            for (int pt = PieceType::PAWN; pt <= PieceType::KING; pt++)
+            if constexpr (US == Color::BLACK)
             {
-                for (int sq = Square::A1; sq <= Square::H8; sq++)
-                {
-                    table[pt][MG][sq] = psqt_b[pt][MG][SQUARES_MIRRORED[sq]];
-                    table[pt][EG][sq] = psqt_b[pt][EG][SQUARES_MIRRORED[sq]];
-                }
+                eval = -eval;
             }
 
-            return table;
-        }();
+            // Tempo Bonus
+            const Score tempo_bonus =
+              scale_eval(mg_score(TEMPO_BONUS), eg_score(TEMPO_BONUS), phase);
+            eval += tempo_bonus;
+
+            return eval;
+        }
 
-        std::pair<Score, Score> evaluate_pawns(const Position& pos) {
-            Score eval_mg = 0;
-            Score eval_eg = 0;
+        template<Color US, typename Trace>
+        Score evaluate(const Position&      pos,
+                       const MaterialEntry& material,
+                       const PawnEntry&     pawns,
+                       const LazyWindow*    window,
+                       bool*                is_lazy,
+                       Trace&               trace) {
+            assert(pos.stm() == US);
 
-            // WHITE
+            if (material.hasEvaluator())
             {
-                auto w_p_bb = pos.pieces(Color::WHITE, PieceType::PAWN);
-                while (w_p_bb)
-                {
-                    const auto sq = w_p_bb.pop_lsb();
-                    eval_mg += psqt_w[PieceType::PAWN][MG][sq];
-                    eval_eg += psqt_w[PieceType::PAWN][EG][sq];
-                }
+                const auto& endgame = material.evaluator;
+                const Score eval    = endgame.fn(pos, endgame.strong);
+                return (endgame.strong == US) ? eval : -eval;
             }
 
-            // BLACK
+            const auto wksq = static_cast<Square>(pos.pieces(Color::WHITE, PieceType::KING).lsb());
+            const auto bksq = static_cast<Square>(pos.pieces(Color::BLACK, PieceType::KING).lsb());
+
+            // Cheap terms: material and PSQT are kept up to date by Position, the rest is cached
+            i32 score = pos.psqt() + material.imbalance;
+            if constexpr (Trace::ENABLED)
             {
-                auto b_p_bb = pos.pieces(Color::BLACK, PieceType::PAWN);
-                while (b_p_bb)
-                {
-                    const auto sq = b_p_bb.pop_lsb();
-                    eval_mg -= psqt_b[PieceType::PAWN][MG][sq];
-                    eval_eg -= psqt_b[PieceType::PAWN][EG][sq];
-                }
+                tracePsqt(pos, trace);
             }
 
-            return std::make_pair(eval_mg, eval_eg);
-        }
-
-        class PawnCache {
-           public:
-            [[nodiscard]] std::pair<Score, Score> probe(const Position& pos) noexcept {
-                const u64 pawn_key = pos.pawn_key();
-
-                auto& entry = m_entries[static_cast<std::size_t>(pawn_key % SIZE)];
+            score += pawns.score + pawns.kingShelter(Color::WHITE, wksq)
+                   - pawns.kingShelter(Color::BLACK, bksq);
 
-                if (entry.pawn_key != pawn_key)
+            if (window)
+            {
+                const Score cheap = blend<US>(pos, material, score);
+                if ((cheap - window->margin >= window->beta)
+                    || (cheap + window->margin <= window->alpha))
                 {
-                    entry.eval     = evaluate_pawns(pos);
-                    entry.pawn_key = pawn_key;
+                    *is_lazy = true;
+                    return cheap;
                 }
-
-                return entry.eval;
             }
 
-           private:
-            static constexpr std::size_t SIZE = 128 * 1024;
+            // Expensive terms
+            AttackInfo ai;
+            score += evaluateAttacks(pos, pawns, ai, trace);
 
-            struct PawnEvalEntry {
-                u64                     pawn_key{};
-                std::pair<Score, Score> eval{};
-            };
-
-            std::array<PawnEvalEntry, SIZE> m_entries{};
-        };
+            return blend<US>(pos, material, score);
+        }
 
     }
 
+    template<Color US>
     Score evaluate(const Position& pos) {
-        i32   phase   = TOTAL_PHASE;
-        Score eval_mg = 0;
-        Score eval_eg = 0;
-
-        // Evaluate Pawns
-        static PawnCache pawn_cache{};
-
-        const auto pawn_eval = pawn_cache.probe(pos);
-        eval_mg              = pawn_eval.first;
-        eval_eg              = pawn_eval.second;
-
-        // Evaluate Pieces
-        const auto w_p = pos.pieces(Color::WHITE);
-        const auto b_p = pos.pieces(Color::BLACK);
-
-        for (int pt = PieceType::KNIGHT; pt <= PieceType::KING; pt++)
-        {
-            const auto pt_bb = pos.pieces(static_cast<PieceType>(pt));
-            // WHITE
-            auto pt_bb_w = pt_bb & w_p;
-            while (pt_bb_w)
-            {
-                phase -= PHASE_WEIGHTS[pt];
-                const auto sq = pt_bb_w.pop_lsb();
-                eval_mg += psqt_w[pt][MG][sq];
-                eval_eg += psqt_w[pt][EG][sq];
-            }
-            // BLACK
-            auto pt_bb_b = pt_bb & b_p;
-            while (pt_bb_b)
-            {
-                phase -= PHASE_WEIGHTS[pt];
-                const auto sq = pt_bb_b.pop_lsb();
-                eval_mg -= psqt_b[pt][MG][sq];
-                eval_eg -= psqt_b[pt][EG][sq];
-            }
-        }
-
-        phase = std_phase(phase);
-#ifdef DEBUG
-        assert(phase == pos_phase(pos));
-#endif
-
-        Score eval = scale_eval(eval_mg, eval_eg, phase);
-
-        const auto stm = 1 - (2 * pos.stm());
-
-        eval *= stm;
-
-        // Tempo Bonus
-        const Score tempo_bonus = scale_eval(mg_score(TEMPO_BONUS), eg_score(TEMPO_BONUS), phase);
-        eval += tempo_bonus;
+        NoTrace trace;
+        return evaluate<US>(pos, computeMaterial(pos), computePawns(pos), nullptr, nullptr, trace);
+    }
 
-        return eval;
+    template<Color US>
+    Score evaluate(const Position& pos, Caches& caches) {
+        NoTrace trace;
+        return evaluate<US>(pos, caches.material.probe(pos), caches.pawns.probe(pos), nullptr,
+                            nullptr, trace);
     }
 
-    bool isEndGame(const Position& pos) {
-        const auto queens = pos.pieceCount(PieceType::QUEEN);
+    template<Color US>
+    Score evaluate(const Position& pos, Caches& caches, const LazyWindow& window, bool* is_lazy) {
+        NoTrace trace;
+        *is_lazy = false;
+        return evaluate<US>(pos, caches.material.probe(pos), caches.pawns.probe(pos), &window,
+                            is_lazy, trace);
+    }
 
-        if (queens == 0)
-        {
-            return true;
-        }
+    template<Color US>
+    Score evaluate(const Position& pos, EvalTrace& trace) {
+        const MaterialEntry material = computeMaterial(pos, trace);
+        const PawnEntry     pawns    = computePawns(pos, trace);
+        return evaluate<US>(pos, material, pawns, nullptr, nullptr, trace);
+    }
 
-        if ((queens == 2) && (pos.pieceCount(PieceType::ROOK) == 0))
-        {
-            const auto w_minors_bb = pos.pieces(Color::WHITE, PieceType::KNIGHT, PieceType::BISHOP);
-            const auto b_minors_bb = pos.pieces(Color::BLACK, PieceType::KNIGHT, PieceType::BISHOP);
+    template Score evaluate<Color::WHITE>(const Position&);
+    template Score evaluate<Color::BLACK>(const Position&);
+    template Score evaluate<Color::WHITE>(const Position&, Caches&);
+    template Score evaluate<Color::BLACK>(const Position&, Caches&);
+    template Score evaluate<Color::WHITE>(const Position&, Caches&, const LazyWindow&, bool*);
+    template Score evaluate<Color::BLACK>(const Position&, Caches&, const LazyWindow&, bool*);
+    template Score evaluate<Color::WHITE>(const Position&, EvalTrace&);
+    template Score evaluate<Color::BLACK>(const Position&, EvalTrace&);
 
-            return ((w_minors_bb.count() <= 1) && (b_minors_bb.count() <= 1));
-        }
+    Score evaluate(const Position& pos) {
+        return (pos.stm() == Color::WHITE) ? evaluate<Color::WHITE>(pos)
+                                           : evaluate<Color::BLACK>(pos);
+    }
 
-        return false;
+    Score evaluate(const Position& pos, EvalTrace& trace) {
+        return (pos.stm() == Color::WHITE) ? evaluate<Color::WHITE>(pos, trace)
+                                           : evaluate<Color::BLACK>(pos, trace);
     }
 
 }
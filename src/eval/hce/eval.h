@@ -3,10 +3,49 @@
 #include "commons/pch.h"
 #include "core/position.h"
 #include "core/types.h"
+#include "eval/hce/attacks.h"
+#include "eval/hce/material.h"
+#include "eval/hce/pawns.h"
+#include "eval/hce/trace.h"
 
 namespace sagittar::eval::hce {
 
+    // Tables owned by each search thread
+    struct Caches {
+        MaterialTable material;
+        PawnTable     pawns;
+
+        void allocate() {
+            material.allocate();
+            pawns.allocate();
+        }
+    };
+
     Score evaluate(const Position&);
-    bool  isEndGame(const Position&);
+
+    // Side to move known at compile time
+    template<Color US>
+    Score evaluate(const Position&);
+
+    template<Color US>
+    Score evaluate(const Position&, Caches&);
+
+    // Search window of a lazy evaluation, and how far the expensive terms may move the score
+    struct LazyWindow {
+        Score alpha;
+        Score beta;
+        Score margin;
+    };
+
+    // Skips the expensive terms when the cheap ones leave the score more than margin outside
+    // [alpha, beta]. The score is then an estimate, and is_lazy is set.
+    template<Color US>
+    Score evaluate(const Position&, Caches&, const LazyWindow&, bool* is_lazy);
+
+    // Also records how often each term applies, for the tuner. Uncached.
+    Score evaluate(const Position&, EvalTrace&);
+
+    template<Color US>
+    Score evaluate(const Position&, EvalTrace&);
 
 }
@@ -0,0 +1,169 @@
+#include "kpk.h"
+
+namespace sagittar::eval::hce::kpk {
+
+    namespace {
+
+        // Positions are stored as 64x64 bit matrices, one per pawn square and side to move. Bits
+        // of a white to move row are white king squares, bits of a black to move row are black
+        // king squares. Both stay plain u64 for the compile time evaluation to be cheap.
+        using Matrix = std::array<u64, 64>;
+
+        // The pawn on files A to D, ranks 2 to 7. Other files are mirrored.
+        constexpr int PAWN_SQUARES = 24;
+
+        constexpr u64 FILE_A = 0x0101010101010101ULL;
+        constexpr u64 FILE_H = 0x8080808080808080ULL;
+
+        constexpr u64 bit(const int sq) { return 1ULL << sq; }
+
+        // Every square next to one of b
+        constexpr u64 kingSpread(const u64 b) {
+            const u64 west = (b >> 1) & ~FILE_H;
+            const u64 east = (b << 1) & ~FILE_A;
+            const u64 row  = b | west | east;
+            return (row << 8) | (row >> 8) | west | east;
+        }
+
+        constexpr u64 kingAttacks(const int sq) { return kingSpread(bit(sq)); }
+
+        constexpr u64 pawnAttacks(const int sq) {
+            return ((bit(sq) << 7) & ~FILE_H) | ((bit(sq) << 9) & ~FILE_A);
+        }
+
+        constexpr int pawnSquare(const int index) { return 8 * (index / 4 + 1) + (index % 4); }
+
+        // Switches between rows by white king and rows by black king
+        constexpr Matrix transpose(Matrix m) {
+            u64 mask = 0x00000000FFFFFFFFULL;
+            for (int j = 32; j != 0; j >>= 1, mask ^= mask << j)
+            {
+                for (int k = 0; k < 64; k = ((k | j) + 1) & ~j)
+                {
+                    const u64 t = ((m[k] >> j) ^ m[k | j]) & mask;
+                    m[k] ^= t << j;
+                    m[k | j] ^= t;
+                }
+            }
+            return m;
+        }
+
+        struct Bitbase {
+            std::array<Matrix, PAWN_SQUARES> white_to_move{};  // [pawn][black king]
+            std::array<Matrix, PAWN_SQUARES> black_to_move{};  // [pawn][white king]
+        };
+
+        // Retrograde analysis, from the 7th rank down, as pawn pushes only lead to pawn squares
+        // already solved. For each pawn square, iterates until no result changes.
+        constexpr Bitbase generate() {
+            Bitbase bitbase{};
+
+            for (int p = PAWN_SQUARES - 1; p >= 0; p--)
+            {
+                const int psq = pawnSquare(p);
+
+                Matrix legal_w{};  // [black king], by white king
+                Matrix legal_b{};  // [white king], by black king
+                Matrix won_w{};    // [black king], wins without a king move
+                Matrix drawn_b{};  // [white king], stalemate or the pawn captured
+
+                for (int k = 0; k < 64; k++)
+                {
+                    const u64 taken = bit(k) | kingAttacks(k) | bit(psq);
+                    legal_w[k] = ((k == psq) || (pawnAttacks(psq) & bit(k))) ? 0 : ~taken;
+                    legal_b[k] = (k == psq) ? 0 : ~taken;
+
+                    const u64 stalemate = ~kingSpread(~(kingAttacks(k) | pawnAttacks(psq)));
+                    const u64 capture   = (kingAttacks(k) & bit(psq)) ? 0 : kingAttacks(psq);
+                    drawn_b[k]          = legal_b[k] & (stalemate | capture);
+                }
+
+                if (psq >= 48)
+                {
+                    // Promotes, unless the new queen is lost at once
+                    const int queening = psq + 8;
+                    for (int bk = 0; bk < 64; bk++)
+                    {
+                        if (bk == queening)
+                        {
+                            continue;
+                        }
+                        won_w[bk] = (kingAttacks(bk) & bit(queening)) ? kingAttacks(queening)
+                                                                      : ~bit(queening);
+                    }
+                }
+                else
+                {
+                    won_w = transpose(bitbase.black_to_move[p + 4]);
+                    if (psq < 16)
+                    {
+                        const Matrix pushed = transpose(bitbase.black_to_move[p + 8]);
+                        for (int bk = 0; bk < 64; bk++)
+                        {
+                            if (bk != psq + 8)
+                            {
+                                won_w[bk] |= pushed[bk] & ~bit(psq + 8);
+                            }
+                        }
+                    }
+                }
+
+                for (int bk = 0; bk < 64; bk++)
+                {
+                    won_w[bk] &= legal_w[bk];
+                }
+
+                const Matrix legal_w_by_wk = transpose(legal_w);
+
+                Matrix& wins_w = bitbase.white_to_move[p];
+                Matrix& wins_b = bitbase.black_to_move[p];
+
+                bool changed = true;
+                while (changed)
+                {
+                    changed = false;
+
+                    // White wins with a king move to a won position
+                    const Matrix wins_b_by_bk = transpose(wins_b);
+                    for (int bk = 0; bk < 64; bk++)
+                    {
+                        const u64 wins = legal_w[bk] & (won_w[bk] | kingSpread(wins_b_by_bk[bk]));
+                        changed |= (wins != wins_w[bk]);
+                        wins_w[bk] = wins;
+                    }
+
+                    // Black loses when every king move leads to a won position
+                    const Matrix wins_w_by_wk = transpose(wins_w);
+                    for (int wk = 0; wk < 64; wk++)
+                    {
+                        const u64 escapes = legal_w_by_wk[wk] & ~wins_w_by_wk[wk];
+                        const u64 wins    = legal_b[wk] & ~drawn_b[wk] & ~kingSpread(escapes);
+                        changed |= (wins != wins_b[wk]);
+                        wins_b[wk] = wins;
+                    }
+                }
+            }
+
+            return bitbase;
+        }
+
+        constexpr Bitbase BITBASE = generate();
+
+    }
+
+    bool probe(Square wksq, Square wpsq, Square bksq, const Color stm) {
+        if (sq2file(wpsq) > File::FILE_D)
+        {
+            wksq = static_cast<Square>(wksq ^ 7);
+            wpsq = static_cast<Square>(wpsq ^ 7);
+            bksq = static_cast<Square>(bksq ^ 7);
+        }
+
+        const int p = 4 * (sq2rank(wpsq) - Rank::RANK_2) + sq2file(wpsq);
+        assert(p >= 0 && p < PAWN_SQUARES);
+
+        return (stm == Color::WHITE) ? (BITBASE.white_to_move[p][bksq] >> wksq) & 1
+                                     : (BITBASE.black_to_move[p][wksq] >> bksq) & 1;
+    }
+
+}
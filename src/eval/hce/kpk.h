@@ -0,0 +1,12 @@
+#pragma once
+
+#include "commons/pch.h"
+#include "core/types.h"
+
+namespace sagittar::eval::hce::kpk {
+
+    // Exact result of king and pawn against king, from the bitbase built at compile time. With
+    // the pawn's side as white, whether white wins with stm to move.
+    bool probe(const Square wksq, const Square wpsq, const Square bksq, const Color stm);
+
+}
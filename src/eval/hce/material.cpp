@@ -0,0 +1,99 @@
+#include "material.h"
+#include "eval/hce/defs.h"
+
+namespace sagittar::eval::hce {
+
+    namespace {
+
+        i32 nonPawnMaterial(const Position& pos, const Color c) {
+            i32 npm = 0;
+            for (int pt = PieceType::KNIGHT; pt <= PieceType::QUEEN; pt++)
+            {
+                const PieceType t = static_cast<PieceType>(pt);
+                npm += pos.pieceCount(pieceCreate(t, c)) * mg_score(PIECE_SCORES[t]);
+            }
+            return npm;
+        }
+
+        bool isEndGame(const Position& pos) {
+            const auto queens = pos.pieceCount(PieceType::QUEEN);
+
+            if (queens == 0)
+            {
+                return true;
+            }
+
+            if ((queens == 2) && (pos.pieceCount(PieceType::ROOK) == 0))
+            {
+                const auto w_minors_bb =
+                  pos.pieces(Color::WHITE, PieceType::KNIGHT, PieceType::BISHOP);
+                const auto b_minors_bb =
+                  pos.pieces(Color::BLACK, PieceType::KNIGHT, PieceType::BISHOP);
+
+                return ((w_minors_bb.count() <= 1) && (b_minors_bb.count() <= 1));
+            }
+
+            return false;
+        }
+
+    }
+
+    template<typename Trace>
+    MaterialEntry computeMaterial(const Position& pos, Trace& trace) {
+        MaterialEntry entry;
+
+        entry.key       = pos.material_key();
+        entry.phase     = pos_phase(pos);
+        entry.endgame   = isEndGame(pos);
+        entry.evaluator = probeEvaluator(entry.key);
+
+        if (entry.hasEvaluator())
+        {
+            return entry;
+        }
+
+        for (const Color c : {Color::WHITE, Color::BLACK})
+        {
+            if (pos.pieceCount(pieceCreate(PieceType::BISHOP, c)) >= 2)
+            {
+                entry.imbalance += (c == Color::WHITE) ? BISHOP_PAIR_BONUS : -BISHOP_PAIR_BONUS;
+                if constexpr (Trace::ENABLED)
+                {
+                    trace.bishop_pair[c]++;
+                }
+            }
+        }
+
+        // Opposite colored bishops are the only scaled endgame, whatever the pawns
+        if ((pos.pieces(PieceType::KNIGHT, PieceType::ROOK, PieceType::QUEEN).count() == 0)
+            && (pos.pieceCount(Piece::WHITE_BISHOP) == 1)
+            && (pos.pieceCount(Piece::BLACK_BISHOP) == 1))
+        {
+            entry.scalers[Color::WHITE] = scaleOppositeBishops;
+            entry.scalers[Color::BLACK] = scaleOppositeBishops;
+        }
+
+        // Without pawns, being up a minor piece or less is rarely enough
+        for (const Color us : {Color::WHITE, Color::BLACK})
+        {
+            const Color them     = colorFlip(us);
+            const i32   npm_us   = nonPawnMaterial(pos, us);
+            const i32   npm_them = nonPawnMaterial(pos, them);
+            const i32   minor    = mg_score(PIECE_SCORES[PieceType::BISHOP]);
+
+            if ((pos.pieceCount(pieceCreate(PieceType::PAWN, us)) == 0)
+                && (npm_us - npm_them <= minor))
+            {
+                entry.scale[us] = (npm_us < mg_score(PIECE_SCORES[PieceType::ROOK])) ? SCALE_DRAW
+                                : (npm_them <= minor)                                 ? 4
+                                                                                      : 14;
+            }
+        }
+
+        return entry;
+    }
+
+    template MaterialEntry computeMaterial<NoTrace>(const Position&, NoTrace&);
+    template MaterialEntry computeMaterial<EvalTrace>(const Position&, EvalTrace&);
+
+}
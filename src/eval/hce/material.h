@@ -0,0 +1,69 @@
+#pragma once
+
+#include "commons/pch.h"
+#include "core/position.h"
+#include "core/types.h"
+#include "eval/hce/endgame.h"
+#include "eval/hce/trace.h"
+
+namespace sagittar::eval::hce {
+
+    // Everything the eval derives from piece counts alone
+    struct MaterialEntry {
+        u64                          key{0};
+        Endgame                      evaluator{};
+        std::array<EndgameScaler, 2> scalers{};  // By strong side
+        std::array<u8, 2>            scale{SCALE_NORMAL, SCALE_NORMAL};  // By strong side
+        i32                          imbalance{0};     // Packed, from white's point of view
+        i32                          phase{0};         // 0 => MG; 256 => EG
+        bool                         endgame{false};  // Null move pruning is unsafe
+
+        [[nodiscard]] bool hasEvaluator() const { return evaluator.fn != nullptr; }
+
+        [[nodiscard]] u8 scaleFactor(const Position& pos, const Color strong) const {
+            u8 sf = scale[strong];
+            if (scalers[strong] != nullptr)
+            {
+                sf = std::min(sf, scalers[strong](pos, strong));
+            }
+            return sf;
+        }
+    };
+
+    template<typename Trace>
+    MaterialEntry computeMaterial(const Position&, Trace&);
+
+    inline MaterialEntry computeMaterial(const Position& pos) {
+        NoTrace trace;
+        return computeMaterial(pos, trace);
+    }
+
+    // Material entries by material key. There are few distinct piece counts in a game, so the
+    // table is small and never needs clearing.
+    class MaterialTable {
+       public:
+        // From the thread probing it, for the memory to be local to it
+        void allocate() {
+            if (entries.empty())
+            {
+                entries.resize(SIZE);
+            }
+        }
+
+        [[nodiscard]] const MaterialEntry& probe(const Position& pos) {
+            assert(!entries.empty());
+            MaterialEntry& entry = entries[pos.material_key() & (SIZE - 1)];
+            if (entry.key != pos.material_key())
+            {
+                entry = computeMaterial(pos);
+            }
+            return entry;
+        }
+
+       private:
+        static constexpr std::size_t SIZE = 8192;
+
+        std::vector<MaterialEntry> entries;
+    };
+
+}
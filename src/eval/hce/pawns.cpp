@@ -0,0 +1,171 @@
+#include "pawns.h"
+#include "eval/hce/defs.h"
+
+namespace sagittar::eval::hce {
+
+    namespace {
+
+        constexpr BitBoard fillNorth(BitBoard b) {
+            b |= b << 8;
+            b |= b << 16;
+            b |= b << 32;
+            return b;
+        }
+
+        constexpr BitBoard fillSouth(BitBoard b) {
+            b |= b >> 8;
+            b |= b >> 16;
+            b |= b >> 32;
+            return b;
+        }
+
+        // Towards promotion, and away from it, including the squares of b
+        template<Color US>
+        constexpr BitBoard fillForward(const BitBoard b) {
+            return (US == Color::WHITE) ? fillNorth(b) : fillSouth(b);
+        }
+
+        template<Color US>
+        constexpr BitBoard fillBackward(const BitBoard b) {
+            return (US == Color::WHITE) ? fillSouth(b) : fillNorth(b);
+        }
+
+        template<Color US>
+        constexpr BitBoard pushed(const BitBoard b) {
+            return (US == Color::WHITE) ? shift<Direction::NORTH>(b) : shift<Direction::SOUTH>(b);
+        }
+
+        template<Color US>
+        constexpr BitBoard pawnAttacks(const BitBoard b) {
+            return (US == Color::WHITE)
+                   ? (shift<Direction::NORTH_EAST>(b) | shift<Direction::NORTH_WEST>(b))
+                   : (shift<Direction::SOUTH_EAST>(b) | shift<Direction::SOUTH_WEST>(b));
+        }
+
+        constexpr BitBoard adjacentFiles(const BitBoard b) {
+            const BitBoard files = fillNorth(b) | fillSouth(b);
+            return shift<Direction::EAST>(files) | shift<Direction::WEST>(files);
+        }
+
+        template<Color US>
+        constexpr u8 relativeRank(const Square sq) {
+            return (US == Color::WHITE) ? sq2rank(sq) : (7 - sq2rank(sq));
+        }
+
+        // Rearmost pawn of b from US's side, b not empty
+        template<Color US>
+        constexpr Square rearmost(const BitBoard b) {
+            const int sq = (US == Color::WHITE) ? b.lsb() : (63 - __builtin_clzll(b.raw()));
+            return static_cast<Square>(sq);
+        }
+
+        template<Color US, typename Trace>
+        i32 evaluatePawns(const Position& pos, PawnEntry& entry, Trace& trace) {
+            constexpr Color THEM = colorFlip(US);
+
+            const BitBoard ours   = pos.pieces(US, PieceType::PAWN);
+            const BitBoard theirs = pos.pieces(THEM, PieceType::PAWN);
+
+            const BitBoard our_attacks   = pawnAttacks<US>(ours);
+            const BitBoard their_attacks = pawnAttacks<THEM>(theirs);
+
+            // Squares their pawns block or can still contest
+            const BitBoard their_span =
+              fillForward<THEM>(pushed<THEM>(theirs)) | fillForward<THEM>(their_attacks);
+            const BitBoard behind_own = fillBackward<US>(pushed<THEM>(ours));
+
+            const BitBoard passed    = ours & ~their_span & ~behind_own;
+            const BitBoard doubled   = ours & behind_own;
+            const BitBoard isolated  = ours & ~adjacentFiles(ours);
+            const BitBoard supported = fillForward<US>(shift<Direction::EAST>(ours)
+                                                       | shift<Direction::WEST>(ours));
+            const BitBoard backward =
+              ours & ~isolated & ~supported & pushed<THEM>(their_attacks);
+            const BitBoard connected =
+              ours & (our_attacks | shift<Direction::EAST>(ours) | shift<Direction::WEST>(ours));
+
+            entry.passed[US]      = passed;
+            entry.attacks[US]     = our_attacks;
+            entry.attack_span[US] = fillForward<US>(our_attacks);
+
+            i32 score = 0;
+
+            BitBoard bb = passed;
+            while (bb)
+            {
+                const u8 rank = relativeRank<US>(static_cast<Square>(bb.pop_lsb()));
+                score += PASSED_PAWN[rank];
+                if constexpr (Trace::ENABLED)
+                {
+                    trace.passed[rank][US]++;
+                }
+            }
+
+            bb = connected;
+            while (bb)
+            {
+                const u8 rank = relativeRank<US>(static_cast<Square>(bb.pop_lsb()));
+                score += CONNECTED_PAWN[rank];
+                if constexpr (Trace::ENABLED)
+                {
+                    trace.connected[rank][US]++;
+                }
+            }
+
+            score += ISOLATED_PAWN * isolated.count();
+            score += DOUBLED_PAWN * doubled.count();
+            score += BACKWARD_PAWN * backward.count();
+            if constexpr (Trace::ENABLED)
+            {
+                trace.isolated[US] += isolated.count();
+                trace.doubled[US] += doubled.count();
+                trace.backward[US] += backward.count();
+            }
+
+            // Shelter of a king on each file
+            for (u8 king_file = File::FILE_A; king_file <= File::FILE_H; king_file++)
+            {
+                const u8 center = std::clamp<u8>(king_file, File::FILE_B, File::FILE_G);
+
+                i32 shelter = 0;
+                for (u8 f = center - 1; f <= center + 1; f++)
+                {
+                    const BitBoard our_file   = ours & FILE_BB(static_cast<File>(f));
+                    const BitBoard their_file = theirs & FILE_BB(static_cast<File>(f));
+
+                    const u8 shield_rank = our_file ? relativeRank<US>(rearmost<US>(our_file)) : 0;
+                    const u8 storm_rank =
+                      their_file ? relativeRank<US>(rearmost<US>(their_file)) : 0;
+
+                    shelter += PAWN_SHIELD[shield_rank] + PAWN_STORM[storm_rank];
+
+                    if constexpr (Trace::ENABLED)
+                    {
+                        if (king_file == sq2file(pos.pieces(US, PieceType::KING).lsb()))
+                        {
+                            trace.shield[shield_rank][US]++;
+                            trace.storm[storm_rank][US]++;
+                        }
+                    }
+                }
+                entry.shelter[US][king_file] = shelter;
+            }
+
+            return score;
+        }
+
+    }
+
+    template<typename Trace>
+    PawnEntry computePawns(const Position& pos, Trace& trace) {
+        PawnEntry entry;
+        entry.key   = pos.pawn_key();
+        entry.score = evaluatePawns<Color::WHITE>(pos, entry, trace)
+                    - evaluatePawns<Color::BLACK>(pos, entry, trace);
+        return entry;
+    }
+
+    template PawnEntry computePawns<NoTrace>(const Position&, NoTrace&);
+    template PawnEntry computePawns<EvalTrace>(const Position&, EvalTrace&);
+
+}
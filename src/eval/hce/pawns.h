@@ -0,0 +1,63 @@
+#pragma once
+
+#include "commons/pch.h"
+#include "core/bitboard.h"
+#include "core/position.h"
+#include "core/types.h"
+#include "eval/hce/trace.h"
+
+namespace sagittar::eval::hce {
+
+    // Pawn structure, a function of the pawns alone
+    struct PawnEntry {
+        u64                     key{~0ULL};  // Must not match the key of no pawns, 0
+        i32                     score{0};    // Packed, from white's point of view
+        std::array<BitBoard, 2> passed{};
+        std::array<BitBoard, 2> attacks{};
+        std::array<BitBoard, 2> attack_span{};  // Squares the pawns attack or can come to attack
+
+        // Packed, for a king of each color on each file, from that color's point of view
+        std::array<std::array<i32, 8>, 2> shelter{};
+
+        [[nodiscard]] i32 kingShelter(const Color c, const Square ksq) const {
+            return shelter[c][sq2file(ksq)];
+        }
+    };
+
+    // A traced computation records the shelter terms for the actual king files only
+    template<typename Trace>
+    PawnEntry computePawns(const Position&, Trace&);
+
+    inline PawnEntry computePawns(const Position& pos) {
+        NoTrace trace;
+        return computePawns(pos, trace);
+    }
+
+    // Pawn entries by pawn key, one table per search thread
+    class PawnTable {
+       public:
+        // From the thread probing it, for the memory to be local to it
+        void allocate() {
+            if (entries.empty())
+            {
+                entries.resize(SIZE);
+            }
+        }
+
+        [[nodiscard]] const PawnEntry& probe(const Position& pos) {
+            assert(!entries.empty());
+            PawnEntry& entry = entries[pos.pawn_key() & (SIZE - 1)];
+            if (entry.key != pos.pawn_key())
+            {
+                entry = computePawns(pos);
+            }
+            return entry;
+        }
+
+       private:
+        static constexpr std::size_t SIZE = 16384;
+
+        std::vector<PawnEntry> entries;
+    };
+
+}
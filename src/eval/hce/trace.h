@@ -0,0 +1,43 @@
+#pragma once
+
+#include "commons/pch.h"
+#include "core/types.h"
+
+namespace sagittar::eval::hce {
+
+    // Tracing policies of the evaluation. With NoTrace, every trace statement compiles out. With
+    // EvalTrace, the evaluation counts how often each term applies, by color, which are the
+    // tuner's coefficients.
+    struct NoTrace {
+        static constexpr bool ENABLED = false;
+    };
+
+    struct EvalTrace {
+        static constexpr bool ENABLED = true;
+
+        // Material and PSQT
+        i32 piece_counts[6][2]   = {};
+        i32 psq_counts[6][64][2] = {};  // Indexed like PSQT_SCORES
+
+        // Material
+        i32 bishop_pair[2] = {};
+
+        // Pawns, by relative rank where indexed
+        i32 passed[8][2]    = {};
+        i32 connected[8][2] = {};
+        i32 isolated[2]     = {};
+        i32 doubled[2]      = {};
+        i32 backward[2]     = {};
+        i32 shield[8][2]    = {};
+        i32 storm[8][2]     = {};
+
+        // Attacks
+        i32 mobility[4][28][2]     = {};  // [piece type - KNIGHT][attacked squares]
+        i32 king_zone_attack[6][2] = {};
+        i32 threat_by_pawn[6][2]   = {};
+        i32 threat_by_minor[6][2]  = {};
+        i32 threat_by_rook[6][2]   = {};
+        i32 space[2]               = {};
+    };
+
+}
@@ -3,6 +3,7 @@
 #include "core/position.h"
 #include "eval/hce/eval.h"
 #include "eval/hce/tuner/base.h"
+#include "eval/hce/tuner/wdl.h"
 
 namespace sagittar::eval::hce::tuner {
 
@@ -11,20 +12,41 @@ namespace sagittar::eval::hce::tuner {
     constexpr size_t NB_COLOR     = 2;
     constexpr size_t NB_PIECETYPE = 6;
     constexpr size_t NB_SQUARE    = 64;
+    constexpr size_t NB_RANK      = 8;
 
     constexpr size_t N_PARAMS = NB_PIECETYPE                 // Piece Scores
-                              + (NB_PIECETYPE * NB_SQUARE);  // PSQT
-
-    struct EvalTrace {
-        i32 piece_counts[NB_PIECETYPE][NB_COLOR]          = {};
-        i32 psq_counts[NB_PIECETYPE][NB_SQUARE][NB_COLOR] = {};
-    };
+                              + (NB_PIECETYPE * NB_SQUARE)   // PSQT
+                              + 1                            // Bishop Pair
+                              + (NB_RANK * 2)                // Passed, Connected Pawns
+                              + 3                            // Isolated, Doubled, Backward
+                              + (NB_RANK * 2)                // Pawn Shield, Storm
+                              + (9 + 14 + 15 + 28)           // Mobility
+                              + NB_PIECETYPE                 // King Zone Attacks
+                              + (NB_PIECETYPE * 3)           // Threats
+                              + 1;                           // Space
 
     static ParameterVector init_parameters() {
         ParameterVector params{};
 
         init_param_array(params, PIECE_SCORES, NB_PIECETYPE);
         init_param_array_2d(params, PSQT_SCORES, NB_PIECETYPE, NB_SQUARE);
+        init_param_single(params, BISHOP_PAIR_BONUS);
+        init_param_array(params, PASSED_PAWN, NB_RANK);
+        init_param_array(params, CONNECTED_PAWN, NB_RANK);
+        init_param_single(params, ISOLATED_PAWN);
+        init_param_single(params, DOUBLED_PAWN);
+        init_param_single(params, BACKWARD_PAWN);
+        init_param_array(params, PAWN_SHIELD, NB_RANK);
+        init_param_array(params, PAWN_STORM, NB_RANK);
+        init_param_array(params, MOBILITY_KNIGHT, MOBILITY_KNIGHT.size());
+        init_param_array(params, MOBILITY_BISHOP, MOBILITY_BISHOP.size());
+        init_param_array(params, MOBILITY_ROOK, MOBILITY_ROOK.size());
+        init_param_array(params, MOBILITY_QUEEN, MOBILITY_QUEEN.size());
+        init_param_array(params, KING_ZONE_ATTACK, NB_PIECETYPE);
+        init_param_array(params, THREAT_BY_PAWN, NB_PIECETYPE);
+        init_param_array(params, THREAT_BY_MINOR, NB_PIECETYPE);
+        init_param_array(params, THREAT_BY_ROOK, NB_PIECETYPE);
+        init_param_single(params, SPACE);
 
         if (params.size() != N_PARAMS)
         {
@@ -34,67 +56,77 @@ namespace sagittar::eval::hce::tuner {
         return params;
     }
 
-    static EvalTrace create_eval_trace(const Position& pos) {
-        EvalTrace trace{};
-
-        for (int sq = Square::A1; sq <= Square::H8; sq++)
-        {
-            const Piece p = pos.pieceOn(static_cast<Square>(sq));
-
-            if (p == Piece::NO_PIECE)
-            {
-                continue;
-            }
-
-            const PieceType pt = pieceTypeOf(p);
-            const Color     c  = pieceColorOf(p);
-
-            trace.piece_counts[pt][c]++;
-
-            if (c == Color::WHITE)
-            {
-                trace.psq_counts[pt][SQUARES_MIRRORED[sq]][c]++;
-            }
-            else
-            {
-                trace.psq_counts[pt][sq][c]++;
-            }
-        }
-
-        return trace;
-    }
-
     static void init_entry_coeffs(Entry& e, const EvalTrace& trace) {
         size_t index = 0;
         init_coeff_array(e, trace.piece_counts, NB_PIECETYPE, index);
         init_coeff_array_2d(e, trace.psq_counts, NB_PIECETYPE, NB_SQUARE, index);
+        init_coeff_single(e, trace.bishop_pair, index++);
+        init_coeff_array(e, trace.passed, NB_RANK, index);
+        init_coeff_array(e, trace.connected, NB_RANK, index);
+        init_coeff_single(e, trace.isolated, index++);
+        init_coeff_single(e, trace.doubled, index++);
+        init_coeff_single(e, trace.backward, index++);
+        init_coeff_array(e, trace.shield, NB_RANK, index);
+        init_coeff_array(e, trace.storm, NB_RANK, index);
+        init_coeff_array(e, trace.mobility[0], MOBILITY_KNIGHT.size(), index);
+        init_coeff_array(e, trace.mobility[1], MOBILITY_BISHOP.size(), index);
+        init_coeff_array(e, trace.mobility[2], MOBILITY_ROOK.size(), index);
+        init_coeff_array(e, trace.mobility[3], MOBILITY_QUEEN.size(), index);
+        init_coeff_array(e, trace.king_zone_attack, NB_PIECETYPE, index);
+        init_coeff_array(e, trace.threat_by_pawn, NB_PIECETYPE, index);
+        init_coeff_array(e, trace.threat_by_minor, NB_PIECETYPE, index);
+        init_coeff_array(e, trace.threat_by_rook, NB_PIECETYPE, index);
+        init_coeff_single(e, trace.space, index++);
     }
 
-    static double extract_wdl(std::string_view fen) {
-        if (fen.find("[1.0]") != (size_t) std::string::npos)
-        {
-            return 1.0;
-        }
-        else if (fen.find("[0.0]") != (size_t) std::string::npos)
-        {
-            return 0.0;
-        }
-        else if (fen.find("[0.5]") != (size_t) std::string::npos)
-        {
-            return 0.5;
-        }
+    // Recognized endgames and scaled material are not linear in the parameters
+    static bool is_linear(const MaterialEntry& material) {
+        return !material.hasEvaluator()
+            && (material.scalers[Color::WHITE] == nullptr)
+            && (material.scalers[Color::BLACK] == nullptr)
+            && (material.scale[Color::WHITE] == SCALE_NORMAL)
+            && (material.scale[Color::BLACK] == SCALE_NORMAL);
+    }
 
-        throw std::runtime_error("Could not find WDL marker");
+    static void print_named_array(ParameterVector&  params,
+                                  const std::string name,
+                                  size_t&           index,
+                                  const size_t      n) {
+        std::cout << name << " = {" << std::endl;
+        print_param_array(params, index, index + n);
+        std::cout << "};" << std::endl;
+        index += n;
     }
 
-    static Entry create_entry(const std::string& fen) {
-        Position pos{};
-        pos.setFen(fen);
+    static void print_params(ParameterVector& params) {
+        print_param_array(params, 0, NB_PIECETYPE);
+        size_t index = print_psqt(params, NB_PIECETYPE);
+        print_named_array(params, "BISHOP_PAIR_BONUS", index, 1);
+        print_named_array(params, "PASSED_PAWN", index, NB_RANK);
+        print_named_array(params, "CONNECTED_PAWN", index, NB_RANK);
+        print_named_array(params, "ISOLATED_PAWN", index, 1);
+        print_named_array(params, "DOUBLED_PAWN", index, 1);
+        print_named_array(params, "BACKWARD_PAWN", index, 1);
+        print_named_array(params, "PAWN_SHIELD", index, NB_RANK);
+        print_named_array(params, "PAWN_STORM", index, NB_RANK);
+        print_named_array(params, "MOBILITY_KNIGHT", index, MOBILITY_KNIGHT.size());
+        print_named_array(params, "MOBILITY_BISHOP", index, MOBILITY_BISHOP.size());
+        print_named_array(params, "MOBILITY_ROOK", index, MOBILITY_ROOK.size());
+        print_named_array(params, "MOBILITY_QUEEN", index, MOBILITY_QUEEN.size());
+        print_named_array(params, "KING_ZONE_ATTACK", index, NB_PIECETYPE);
+        print_named_array(params, "THREAT_BY_PAWN", index, NB_PIECETYPE);
+        print_named_array(params, "THREAT_BY_MINOR", index, NB_PIECETYPE);
+        print_named_array(params, "THREAT_BY_ROOK", index, NB_PIECETYPE);
+        print_named_array(params, "SPACE", index, 1);
+    }
 
-        const EvalTrace trace = create_eval_trace(pos);
+    static Entry create_entry(const Position& pos, const std::string& fen) {
+        // The traced evaluation is the engine's own, so coefficients and eval cannot diverge
+        EvalTrace trace{};
+        const Score seval = evaluate(pos, trace);
 
         Entry e{};
-        e.coefficients.reserve(32);
+        e.coefficients.reserve(64);
 
         init_entry_coeffs(e, trace);
 
@@ -105,7 +137,7 @@ namespace sagittar::eval::hce::tuner {
         e.pfactors[EG] = e.phase / 256.0;
 
         e.wdl   = extract_wdl(fen);
-        e.seval = evaluate(pos);
+        e.seval = seval;
 
         return e;
     }
@@ -134,6 +166,9 @@ namespace sagittar::eval::hce::tuner {
         return eval + (entry.stm == Color::WHITE ? tempo_bonus : -tempo_bonus);
     }
 
+#ifndef NDEBUG
+    // The coefficients are traced by evaluate itself. A mismatch means linear_eval, or the order
+    // of init_parameters against init_coefficients, is out of step with it.
     static bool check_entries_eval(const std::vector<Entry>& entries,
                                    const ParameterVector&    params) {
         for (const Entry& entry : entries)
@@ -150,14 +185,7 @@ namespace sagittar::eval::hce::tuner {
 
         return true;
     }
-
-    static double sigmoid(const double K, const double E) {
-        // E = -INFINITY    -> 0    => BLACK Winning
-        // E = 0            -> 0.5  => Draw
-        // E = +INFINITY    -> 1    => WHITE Winning
-
-        return 1.0 / (1.0 + exp(-K * E / 400.0));
-    }
+#endif
 
     static double mse(ThreadPool&               pool,
                       const size_t              nthreads,
@@ -350,8 +378,7 @@ namespace sagittar::eval::hce::tuner {
                 const double error = mse(pool, nthreads, entries, params, K);
 
                 std::cout << "Current Parameters:" << std::endl;
-                print_param_array(params, 0, NB_PIECETYPE);
-                print_psqt(params, NB_PIECETYPE);
+                print_params(params);
 
                 std::cout << "Epoch = " << (size_t) i << "\tError = " << error
                           << "\tLearning Rate = " << (double) learning_rate << std::endl;
@@ -381,7 +408,15 @@ namespace sagittar::eval::hce::tuner {
                 continue;
             }
 
-            entries.emplace_back(create_entry(line));
+            Position pos{};
+            pos.setFen(line);
+
+            if (!is_linear(computeMaterial(pos)))
+            {
+                continue;
+            }
+
+            entries.emplace_back(create_entry(pos, line));
         }
     }
 
@@ -395,16 +430,10 @@ namespace sagittar::eval::hce::tuner {
         ParameterVector params = init_parameters();
 
         std::cout << "Initial Parameters:\n" << std::endl;
-        print_param_array(params, 0, NB_PIECETYPE);
-        print_psqt(params, NB_PIECETYPE);
+        print_params(params);
         std::cout << "No. of Parameters: " << (size_t) N_PARAMS << std::endl;
 
-        if (!check_entries_eval(entries, params))
-        {
-            std::cerr << "Eval check failed!" << std::endl;
-            return;
-        }
-        std::cout << "Eval check succeeded" << std::endl;
+        assert(check_entries_eval(entries, params));
 
         if (settings.retune_from_zero)
         {
@@ -414,8 +443,7 @@ namespace sagittar::eval::hce::tuner {
                 params[i][MG] = params[i][EG] = 0;
             }
             std::cout << "Zero-ed Parameters:\n" << std::endl;
-            print_param_array(params, 0, NB_PIECETYPE);
-            print_psqt(params, NB_PIECETYPE);
+            print_params(params);
         }
 
         std::cout << "Using dp::thread-pool version " << THREADPOOL_VERSION << '\n';
@@ -443,8 +471,7 @@ namespace sagittar::eval::hce::tuner {
         run(pool, nthreads, params, entries, K, settings);
 
         std::cout << "Tuned Parameters:" << std::endl;
-        print_param_array(params, 0, NB_PIECETYPE);
-        print_psqt(params, NB_PIECETYPE);
+        print_params(params);
 
         std::cout << "Tuning complete" << std::endl;
     }
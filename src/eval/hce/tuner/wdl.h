@@ -0,0 +1,35 @@
+#pragma once
+
+#include "commons/pch.h"
+
+// Dataset labels and the eval to win probability mapping, shared by the HCE tuner and the NNUE
+// trainer
+namespace sagittar::eval::hce::tuner {
+
+    // Game result marker of a dataset line, from WHITE's point of view
+    inline double extract_wdl(std::string_view fen) {
+        if (fen.find("[1.0]") != (size_t) std::string::npos)
+        {
+            return 1.0;
+        }
+        else if (fen.find("[0.0]") != (size_t) std::string::npos)
+        {
+            return 0.0;
+        }
+        else if (fen.find("[0.5]") != (size_t) std::string::npos)
+        {
+            return 0.5;
+        }
+
+        throw std::runtime_error("Could not find WDL marker");
+    }
+
+    inline double sigmoid(const double K, const double E) {
+        // E = -INFINITY    -> 0    => BLACK Winning
+        // E = 0            -> 0.5  => Draw
+        // E = +INFINITY    -> 1    => WHITE Winning
+
+        return 1.0 / (1.0 + exp(-K * E / 400.0));
+    }
+
+}
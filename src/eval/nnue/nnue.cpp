@@ -0,0 +1,248 @@
+#include "nnue.h"
+#include <cstring>
+#include <fstream>
+#include "eval/nnue/simd.h"
+
+#if defined(SAGITTAR_EMBEDDED_NET)
+    // Network embedded at build time, see EVALFILE in CMakeLists.txt
+    #if defined(__APPLE__)
+        #define SAGITTAR_NET_SECTION ".const_data\n"
+        #define SAGITTAR_NET_SYMBOL(name) "_" #name
+    #else
+        #define SAGITTAR_NET_SECTION ".section .rodata\n"
+        #define SAGITTAR_NET_SYMBOL(name) #name
+    #endif
+asm(SAGITTAR_NET_SECTION
+    ".balign 64\n"
+    ".global " SAGITTAR_NET_SYMBOL(sagittarEmbeddedNet) "\n"
+    SAGITTAR_NET_SYMBOL(sagittarEmbeddedNet) ":\n"
+    ".incbin \"" SAGITTAR_EMBEDDED_NET "\"\n"
+    ".global " SAGITTAR_NET_SYMBOL(sagittarEmbeddedNetEnd) "\n"
+    SAGITTAR_NET_SYMBOL(sagittarEmbeddedNetEnd) ":\n"
+    ".previous\n");
+extern "C" const unsigned char sagittarEmbeddedNet[];
+extern "C" const unsigned char sagittarEmbeddedNetEnd[];
+#endif
+
+namespace sagittar::eval::nnue {
+
+    namespace {
+
+        constexpr std::size_t PARAMETERS_SIZE =
+          sizeof(i16)
+          * ((INPUT_SIZE * L1_SIZE) + L1_SIZE + (OUTPUT_BUCKETS * 2 * L1_SIZE) + OUTPUT_BUCKETS);
+
+        std::unique_ptr<Network> network;
+
+        template<typename T>
+        void readParameters(T& dst, const std::byte*& src) {
+            std::memcpy(dst.data(), src, sizeof(T));
+            src += sizeof(T);
+        }
+
+        inline const i16* weights(const Color  perspective,
+                                  const Square ksq,
+                                  const Piece  piece,
+                                  const Square sq) {
+            return network->ft_weights[featureIndex(perspective, ksq, piece, sq)].data();
+        }
+
+        inline u8 kingBucket(const Color perspective, const Square ksq) {
+            return KING_BUCKET_LAYOUT[(perspective == Color::WHITE) ? ksq : (ksq ^ 56)];
+        }
+
+    }
+
+    // Parameters are stored little-endian, as laid out in memory on the supported targets
+    bool loadNetwork(std::span<const std::byte> data) {
+        if (data.size() != sizeof(NetworkHeader) + PARAMETERS_SIZE)
+        {
+            return false;
+        }
+
+        NetworkHeader header;
+        std::memcpy(&header, data.data(), sizeof(NetworkHeader));
+
+        if ((header.magic != NETWORK_MAGIC) || (header.version != NETWORK_VERSION)
+            || (header.king_buckets != KING_BUCKETS) || (header.l1_size != L1_SIZE)
+            || (header.output_buckets != OUTPUT_BUCKETS))
+        {
+            return false;
+        }
+
+        auto net = std::make_unique<Network>();
+
+        const std::byte* src = data.data() + sizeof(NetworkHeader);
+        for (auto& row : net->ft_weights)
+        {
+            readParameters(row, src);
+        }
+        readParameters(net->ft_biases, src);
+        for (auto& row : net->l1_weights)
+        {
+            readParameters(row, src);
+        }
+        readParameters(net->l1_biases, src);
+
+        network = std::move(net);
+
+        return true;
+    }
+
+    bool loadNetwork(const std::string& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            return false;
+        }
+
+        const std::streamsize  size = file.tellg();
+        std::vector<std::byte> data(static_cast<std::size_t>(std::max<std::streamsize>(size, 0)));
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(data.data()), size))
+        {
+            return false;
+        }
+
+        return loadNetwork(std::span<const std::byte>(data));
+    }
+
+    bool loadEmbeddedNetwork() {
+#if defined(SAGITTAR_EMBEDDED_NET)
+        const auto* begin = reinterpret_cast<const std::byte*>(sagittarEmbeddedNet);
+        const auto* end   = reinterpret_cast<const std::byte*>(sagittarEmbeddedNetEnd);
+        return loadNetwork(std::span<const std::byte>(begin, end));
+#else
+        return false;
+#endif
+    }
+
+    bool isLoaded() { return network != nullptr; }
+
+    std::size_t featureIndex(const Color  perspective,
+                             const Square ksq,
+                             const Piece  piece,
+                             const Square sq) {
+        const u8 flip = (perspective == Color::WHITE) ? 0 : 56;
+        const u8 side = (pieceColorOf(piece) == perspective) ? 0 : 1;
+        return (kingBucket(perspective, ksq) * 768) + (side * 384) + (pieceTypeOf(piece) * 64)
+             + (sq ^ flip);
+    }
+
+    void refresh(Accumulator& acc, const Position& pos, const Color perspective) {
+        assert(isLoaded());
+
+        auto& values = acc.values[perspective];
+        values       = network->ft_biases;
+
+        const Square ksq = static_cast<Square>(pos.pieces(perspective, PieceType::KING).lsb());
+
+        BitBoard occ = pos.occupied();
+        while (occ)
+        {
+            const Square sq = static_cast<Square>(occ.pop_lsb());
+            simd::add<L1_SIZE>(values.data(), weights(perspective, ksq, pos.pieceOn(sq), sq));
+        }
+    }
+
+    void refresh(Accumulator& acc, const Position& pos) {
+        refresh(acc, pos, Color::WHITE);
+        refresh(acc, pos, Color::BLACK);
+    }
+
+    void update(Accumulator&       child,
+                const Accumulator& parent,
+                const Position&    pos,
+                const Move&        move,
+                const Piece        moved,
+                const Piece        captured) {
+        assert(isLoaded());
+
+        const Square   from   = move.from();
+        const Square   to     = move.to();
+        const MoveFlag flag   = move.flag();
+        const Color    mover  = pieceColorOf(moved);
+        const Piece    placed = pos.pieceOn(to);  // Differs from moved on promotions
+
+        for (const Color perspective : {Color::WHITE, Color::BLACK})
+        {
+            const Square ksq = static_cast<Square>(pos.pieces(perspective, PieceType::KING).lsb());
+
+            // Our king changed bucket, every feature of this side changes
+            if ((pieceTypeOf(moved) == PieceType::KING) && (mover == perspective)
+                && (kingBucket(perspective, from) != kingBucket(perspective, to)))
+            {
+                refresh(child, pos, perspective);
+                continue;
+            }
+
+            i16*       out = child.values[perspective].data();
+            const i16* in  = parent.values[perspective].data();
+
+            if ((flag == MoveFlag::MOVE_CASTLE_KING_SIDE)
+                || (flag == MoveFlag::MOVE_CASTLE_QUEEN_SIDE))
+            {
+                const bool   king_side = (flag == MoveFlag::MOVE_CASTLE_KING_SIDE);
+                const Rank   rank      = sq2rank(from);
+                const Square rook_from = rf2sq(rank, king_side ? File::FILE_H : File::FILE_A);
+                const Square rook_to   = rf2sq(rank, king_side ? File::FILE_F : File::FILE_D);
+                const Piece  rook      = pieceCreate(PieceType::ROOK, mover);
+                simd::addAddSubSub<L1_SIZE>(
+                  out, in, weights(perspective, ksq, moved, to),
+                  weights(perspective, ksq, rook, rook_to), weights(perspective, ksq, moved, from),
+                  weights(perspective, ksq, rook, rook_from));
+            }
+            else if (move.isCapture())
+            {
+                const bool   is_ep = (flag == MoveFlag::MOVE_CAPTURE_EP);
+                const Square capture_sq =
+                  is_ep ? rf2sq(sq2rank(from), sq2file(to)) : to;
+                const Piece victim =
+                  is_ep ? pieceCreate(PieceType::PAWN, colorFlip(mover)) : captured;
+                simd::addSubSub<L1_SIZE>(out, in, weights(perspective, ksq, placed, to),
+                                         weights(perspective, ksq, moved, from),
+                                         weights(perspective, ksq, victim, capture_sq));
+            }
+            else
+            {
+                simd::addSub<L1_SIZE>(out, in, weights(perspective, ksq, placed, to),
+                                      weights(perspective, ksq, moved, from));
+            }
+        }
+    }
+
+    std::size_t outputBucket(const Position& pos) {
+        constexpr std::size_t divisor = (32 + OUTPUT_BUCKETS - 1) / OUTPUT_BUCKETS;
+        return std::min<std::size_t>((pos.occupied().count() - 2) / divisor, OUTPUT_BUCKETS - 1);
+    }
+
+    template<Color US>
+    Score evaluate(const Position& pos, const Accumulator& acc) {
+        assert(isLoaded());
+
+        constexpr Color them = colorFlip(US);
+
+        const std::size_t bucket = outputBucket(pos);
+        const i16*        w      = network->l1_weights[bucket].data();
+
+        i32 out = simd::screluDot<L1_SIZE, QA>(acc.values[US].data(), w)
+                + simd::screluDot<L1_SIZE, QA>(acc.values[them].data(), w + L1_SIZE);
+
+        out = (out / QA) + network->l1_biases[bucket];
+
+        // A network in the trainer's clip range can still go far outside the score range
+        const std::int64_t eval = (static_cast<std::int64_t>(out) * SCALE) / (QA * QB);
+        return static_cast<Score>(std::clamp<std::int64_t>(eval, -MAX_EVAL, MAX_EVAL));
+    }
+
+    template Score evaluate<Color::WHITE>(const Position&, const Accumulator&);
+    template Score evaluate<Color::BLACK>(const Position&, const Accumulator&);
+
+    Score evaluate(const Position& pos) {
+        Accumulator acc;
+        refresh(acc, pos);
+        return (pos.stm() == Color::WHITE) ? evaluate<Color::WHITE>(pos, acc)
+                                           : evaluate<Color::BLACK>(pos, acc);
+    }
+
+}
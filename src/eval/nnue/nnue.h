@@ -0,0 +1,92 @@
+#pragma once
+
+#include "commons/pch.h"
+#include "core/move.h"
+#include "core/position.h"
+#include "core/types.h"
+
+namespace sagittar::eval::nnue {
+
+    // (768 x KING_BUCKETS -> L1_SIZE) x 2 -> OUTPUT_BUCKETS
+    // Inputs are king-bucketed piece-square features seen from each side: the board is flipped
+    // vertically for black, and "our" pieces come before "their" pieces. The two accumulators are
+    // concatenated side to move first, activated with a squared clipped ReLU, and fed to one of
+    // the output neurons, chosen by the number of pieces on the board.
+    constexpr std::size_t KING_BUCKETS   = 4;
+    constexpr std::size_t INPUT_SIZE     = 768 * KING_BUCKETS;
+    constexpr std::size_t L1_SIZE        = 256;
+    constexpr std::size_t OUTPUT_BUCKETS = 8;
+
+    constexpr i16 QA    = 255;
+    constexpr i16 QB    = 64;
+    constexpr i32 SCALE = 400;
+
+    // Bound of the output, below the search's proven win scores and within the i16 caches
+    constexpr Score MAX_EVAL = 11999;
+
+    // File header, followed by the quantized parameters in the order of Network
+    constexpr u32 NETWORK_MAGIC   = 0x4E4E4753;  // "SGNN"
+    constexpr u32 NETWORK_VERSION = 1;
+
+    struct NetworkHeader {
+        u32 magic;
+        u32 version;
+        u32 king_buckets;
+        u32 l1_size;
+        u32 output_buckets;
+    };
+
+    // clang-format off
+    // From the point of view of the side whose king it is
+    constexpr std::array<u8, 64> KING_BUCKET_LAYOUT = {
+        0, 0, 0, 0, 1, 1, 1, 1,
+        2, 2, 2, 2, 2, 2, 2, 2,
+        3, 3, 3, 3, 3, 3, 3, 3,
+        3, 3, 3, 3, 3, 3, 3, 3,
+        3, 3, 3, 3, 3, 3, 3, 3,
+        3, 3, 3, 3, 3, 3, 3, 3,
+        3, 3, 3, 3, 3, 3, 3, 3,
+        3, 3, 3, 3, 3, 3, 3, 3
+    };
+    // clang-format on
+
+    struct Network {
+        alignas(64) std::array<std::array<i16, L1_SIZE>, INPUT_SIZE> ft_weights;
+        alignas(64) std::array<i16, L1_SIZE> ft_biases;
+        alignas(64) std::array<std::array<i16, 2 * L1_SIZE>, OUTPUT_BUCKETS> l1_weights;
+        alignas(64) std::array<i16, OUTPUT_BUCKETS> l1_biases;
+    };
+
+    struct alignas(64) Accumulator {
+        std::array<std::array<i16, L1_SIZE>, 2> values;  // [perspective]
+    };
+
+    // Network parameters are shared by all search threads and must only be (re)loaded while no
+    // search is running
+    bool loadNetwork(const std::string& path);
+    bool loadNetwork(std::span<const std::byte> data);
+    bool loadEmbeddedNetwork();
+    bool isLoaded();
+
+    std::size_t featureIndex(const Color perspective, const Square ksq, const Piece, const Square);
+
+    std::size_t outputBucket(const Position&);
+
+    void refresh(Accumulator&, const Position&);
+    void refresh(Accumulator&, const Position&, const Color perspective);
+
+    // Derives the accumulator of pos from its parent's, pos being the position after the move.
+    // moved and captured are the pieces that moved and were captured, taken before the move.
+    void update(Accumulator&       child,
+                const Accumulator& parent,
+                const Position&    pos,
+                const Move&        move,
+                const Piece        moved,
+                const Piece        captured);
+
+    template<Color US>
+    Score evaluate(const Position&, const Accumulator&);
+
+    Score evaluate(const Position&);
+
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "arch.h"
+#include "commons/pch.h"
+#include "core/types.h"
+
+#if SAGITTAR_HAS_AVX512 || SAGITTAR_HAS_AVX2
+    #include <immintrin.h>
+#endif
+
+// Kernels for the accumulator updates and the output layer.
+// Sizes must be multiples of the register width, all pointers 64 byte aligned.
+namespace sagittar::eval::nnue::simd {
+
+#if SAGITTAR_HAS_AVX512
+    using vec_t                    = __m512i;
+    constexpr std::size_t VEC_SIZE = 32;  // i16 lanes
+    inline vec_t vecLoad(const i16* p) { return _mm512_load_si512(p); }
+    inline void  vecStore(i16* p, const vec_t v) { _mm512_store_si512(p, v); }
+    inline vec_t vecAdd16(const vec_t a, const vec_t b) { return _mm512_add_epi16(a, b); }
+    inline vec_t vecSub16(const vec_t a, const vec_t b) { return _mm512_sub_epi16(a, b); }
+    inline vec_t vecAdd32(const vec_t a, const vec_t b) { return _mm512_add_epi32(a, b); }
+    inline vec_t vecMullo16(const vec_t a, const vec_t b) { return _mm512_mullo_epi16(a, b); }
+    inline vec_t vecMadd16(const vec_t a, const vec_t b) { return _mm512_madd_epi16(a, b); }
+    inline vec_t vecZero() { return _mm512_setzero_si512(); }
+    inline vec_t vecSet16(const i16 x) { return _mm512_set1_epi16(x); }
+    inline vec_t vecClamp16(const vec_t v, const vec_t lo, const vec_t hi) {
+        return _mm512_min_epi16(_mm512_max_epi16(v, lo), hi);
+    }
+    inline i32 vecReduce32(const vec_t v) { return _mm512_reduce_add_epi32(v); }
+#elif SAGITTAR_HAS_AVX2
+    using vec_t                    = __m256i;
+    constexpr std::size_t VEC_SIZE = 16;  // i16 lanes
+    inline vec_t vecLoad(const i16* p) {
+        return _mm256_load_si256(reinterpret_cast<const vec_t*>(p));
+    }
+    inline void vecStore(i16* p, const vec_t v) {
+        _mm256_store_si256(reinterpret_cast<vec_t*>(p), v);
+    }
+    inline vec_t vecAdd16(const vec_t a, const vec_t b) { return _mm256_add_epi16(a, b); }
+    inline vec_t vecSub16(const vec_t a, const vec_t b) { return _mm256_sub_epi16(a, b); }
+    inline vec_t vecAdd32(const vec_t a, const vec_t b) { return _mm256_add_epi32(a, b); }
+    inline vec_t vecMullo16(const vec_t a, const vec_t b) { return _mm256_mullo_epi16(a, b); }
+    inline vec_t vecMadd16(const vec_t a, const vec_t b) { return _mm256_madd_epi16(a, b); }
+    inline vec_t vecZero() { return _mm256_setzero_si256(); }
+    inline vec_t vecSet16(const i16 x) { return _mm256_set1_epi16(x); }
+    inline vec_t vecClamp16(const vec_t v, const vec_t lo, const vec_t hi) {
+        return _mm256_min_epi16(_mm256_max_epi16(v, lo), hi);
+    }
+    inline i32 vecReduce32(const vec_t v) {
+        const __m128i lo   = _mm256_castsi256_si128(v);
+        const __m128i hi   = _mm256_extracti128_si256(v, 1);
+        __m128i       sum  = _mm_add_epi32(lo, hi);
+        sum                = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum                = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(sum);
+    }
+#endif
+
+    // out = in + add - sub
+    template<std::size_t N>
+    inline void addSub(i16* out, const i16* in, const i16* add, const i16* sub) {
+#if SAGITTAR_HAS_AVX512 || SAGITTAR_HAS_AVX2
+        static_assert(N % VEC_SIZE == 0);
+        for (std::size_t i = 0; i < N; i += VEC_SIZE)
+        {
+            vec_t v = vecLoad(in + i);
+            v       = vecAdd16(v, vecLoad(add + i));
+            v       = vecSub16(v, vecLoad(sub + i));
+            vecStore(out + i, v);
+        }
+#else
+        for (std::size_t i = 0; i < N; i++)
+        {
+            out[i] = in[i] + add[i] - sub[i];
+        }
+#endif
+    }
+
+    // out = in + add - sub1 - sub2
+    template<std::size_t N>
+    inline void
+    addSubSub(i16* out, const i16* in, const i16* add, const i16* sub1, const i16* sub2) {
+#if SAGITTAR_HAS_AVX512 || SAGITTAR_HAS_AVX2
+        static_assert(N % VEC_SIZE == 0);
+        for (std::size_t i = 0; i < N; i += VEC_SIZE)
+        {
+            vec_t v = vecLoad(in + i);
+            v       = vecAdd16(v, vecLoad(add + i));
+            v       = vecSub16(v, vecLoad(sub1 + i));
+            v       = vecSub16(v, vecLoad(sub2 + i));
+            vecStore(out + i, v);
+        }
+#else
+        for (std::size_t i = 0; i < N; i++)
+        {
+            out[i] = in[i] + add[i] - sub1[i] - sub2[i];
+        }
+#endif
+    }
+
+    // out = in + add1 + add2 - sub1 - sub2
+    template<std::size_t N>
+    inline void addAddSubSub(i16*       out,
+                             const i16* in,
+                             const i16* add1,
+                             const i16* add2,
+                             const i16* sub1,
+                             const i16* sub2) {
+#if SAGITTAR_HAS_AVX512 || SAGITTAR_HAS_AVX2
+        static_assert(N % VEC_SIZE == 0);
+        for (std::size_t i = 0; i < N; i += VEC_SIZE)
+        {
+            vec_t v = vecLoad(in + i);
+            v       = vecAdd16(v, vecLoad(add1 + i));
+            v       = vecAdd16(v, vecLoad(add2 + i));
+            v       = vecSub16(v, vecLoad(sub1 + i));
+            v       = vecSub16(v, vecLoad(sub2 + i));
+            vecStore(out + i, v);
+        }
+#else
+        for (std::size_t i = 0; i < N; i++)
+        {
+            out[i] = in[i] + add1[i] + add2[i] - sub1[i] - sub2[i];
+        }
+#endif
+    }
+
+    // acc += add
+    template<std::size_t N>
+    inline void add(i16* acc, const i16* add) {
+#if SAGITTAR_HAS_AVX512 || SAGITTAR_HAS_AVX2
+        static_assert(N % VEC_SIZE == 0);
+        for (std::size_t i = 0; i < N; i += VEC_SIZE)
+        {
+            vecStore(acc + i, vecAdd16(vecLoad(acc + i), vecLoad(add + i)));
+        }
+#else
+        for (std::size_t i = 0; i < N; i++)
+        {
+            acc[i] += add[i];
+        }
+#endif
+    }
+
+    // Sum of clamp(x, 0, QA)^2 * w, squared clipped ReLU fused with the dot product.
+    // The product clamp(x) * w is formed in 16 bits first, which requires |w| * QA < 2^15.
+    template<std::size_t N, i16 QA>
+    inline i32 screluDot(const i16* x, const i16* w) {
+#if SAGITTAR_HAS_AVX512 || SAGITTAR_HAS_AVX2
+        static_assert(N % VEC_SIZE == 0);
+        const vec_t zero = vecZero();
+        const vec_t qa   = vecSet16(QA);
+        vec_t       sum  = vecZero();
+        for (std::size_t i = 0; i < N; i += VEC_SIZE)
+        {
+            const vec_t v = vecClamp16(vecLoad(x + i), zero, qa);
+            sum           = vecAdd32(sum, vecMadd16(vecMullo16(v, vecLoad(w + i)), v));
+        }
+        return vecReduce32(sum);
+#else
+        i32 sum = 0;
+        for (std::size_t i = 0; i < N; i++)
+        {
+            const i32 v = std::clamp<i32>(x[i], 0, QA);
+            sum += static_cast<i16>(v * w[i]) * v;
+        }
+        return sum;
+#endif
+    }
+
+}
@@ -0,0 +1,438 @@
+#include "trainer.h"
+
+#include <numeric>
+#include <random>
+#include "core/position.h"
+#include "eval/hce/tuner/wdl.h"
+#include "eval/nnue/nnue.h"
+
+namespace sagittar::eval::nnue::trainer {
+
+    using ThreadPool = dp::thread_pool<>;
+
+    using hce::tuner::extract_wdl;
+    using hce::tuner::sigmoid;
+
+    // Parameters are trained in floating point and kept flat, in the order of Network
+    constexpr size_t FT_WEIGHTS = 0;
+    constexpr size_t FT_BIASES  = FT_WEIGHTS + (INPUT_SIZE * L1_SIZE);
+    constexpr size_t L1_WEIGHTS = FT_BIASES + L1_SIZE;
+    constexpr size_t L1_BIASES  = L1_WEIGHTS + (OUTPUT_BUCKETS * 2 * L1_SIZE);
+    constexpr size_t N_PARAMS   = L1_BIASES + OUTPUT_BUCKETS;
+
+    // Gradients are reduced and applied in rows of L1_SIZE, the first INPUT_SIZE rows being the
+    // sparse feature transformer weights
+    constexpr size_t N_ROWS = (N_PARAMS + L1_SIZE - 1) / L1_SIZE;
+
+    // Keeps quantized accumulators within i16, and the output layer's 16 bit products
+    // (|w| * QB * QA < 2^15) from overflowing
+    constexpr float WEIGHT_CLIP = 1.98f;
+
+    constexpr size_t MAX_FEATURES = 32;
+
+    struct Entry {
+        std::array<std::array<u16, MAX_FEATURES>, 2> features{};  // [perspective]
+        u8                                           feature_count{0};
+        u8                                           bucket{0};
+        Color                                        stm{Color::WHITE};
+        float                                        wdl{0};  // WHITE PoV
+    };
+
+    // Per thread gradient, so that threads never share a cache line while accumulating
+    struct ThreadGradient {
+        std::vector<float> values  = std::vector<float>(N_PARAMS);
+        std::vector<u8>    touched = std::vector<u8>(INPUT_SIZE);  // Rows with a gradient
+        double             loss    = 0;
+    };
+
+    struct Optimizer {
+        std::vector<float> momentum = std::vector<float>(N_PARAMS);
+        std::vector<float> velocity = std::vector<float>(N_PARAMS);
+        size_t             steps    = 0;
+    };
+
+    static std::vector<float> init_parameters(const u32 seed) {
+        std::vector<float> params(N_PARAMS);
+        std::mt19937       rng(seed);
+
+        // Accumulators of roughly unit variance on a full board
+        std::uniform_real_distribution<float> ft_dist(-1.0f / std::sqrt(float(MAX_FEATURES)),
+                                                      1.0f / std::sqrt(float(MAX_FEATURES)));
+        std::uniform_real_distribution<float> l1_dist(-1.0f / std::sqrt(float(2 * L1_SIZE)),
+                                                      1.0f / std::sqrt(float(2 * L1_SIZE)));
+
+        for (size_t i = FT_WEIGHTS; i < FT_BIASES; i++)
+        {
+            params[i] = ft_dist(rng);
+        }
+        for (size_t i = L1_WEIGHTS; i < L1_BIASES; i++)
+        {
+            params[i] = l1_dist(rng);
+        }
+
+        return params;
+    }
+
+    static Entry create_entry(const std::string& fen) {
+        Position pos{};
+        pos.setFen(fen);
+
+        Entry e{};
+        e.stm    = pos.stm();
+        e.bucket = static_cast<u8>(outputBucket(pos));
+        e.wdl    = static_cast<float>(extract_wdl(fen));
+
+        BitBoard occ = pos.occupied();
+        if (static_cast<std::size_t>(occ.count()) > MAX_FEATURES)
+        {
+            throw std::runtime_error("Too many pieces: " + fen);
+        }
+
+        const Square wksq = static_cast<Square>(pos.pieces(Color::WHITE, PieceType::KING).lsb());
+        const Square bksq = static_cast<Square>(pos.pieces(Color::BLACK, PieceType::KING).lsb());
+
+        while (occ)
+        {
+            const Square sq = static_cast<Square>(occ.pop_lsb());
+            const Piece  p  = pos.pieceOn(sq);
+
+            e.features[Color::WHITE][e.feature_count] =
+              static_cast<u16>(featureIndex(Color::WHITE, wksq, p, sq));
+            e.features[Color::BLACK][e.feature_count] =
+              static_cast<u16>(featureIndex(Color::BLACK, bksq, p, sq));
+            e.feature_count++;
+        }
+
+        return e;
+    }
+
+    static void read_epd(std::vector<Entry>& entries, const std::filesystem::path& epd_path) {
+        std::ifstream file(epd_path);
+
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Failed to open EPD file");
+        }
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            // Skip blank/whitespace-only lines
+            if (line.find_first_not_of(" \t\r\n") == std::string::npos)
+            {
+                continue;
+            }
+
+            entries.emplace_back(create_entry(line));
+        }
+    }
+
+    static inline float screlu(const float x) {
+        const float c = std::clamp(x, 0.0f, 1.0f);
+        return c * c;
+    }
+
+    static void update_gradient_single(ThreadGradient&           g,
+                                       const Entry&              entry,
+                                       const std::vector<float>& params,
+                                       const double              K) {
+        // Forward pass: accumulators -> SCReLU -> output bucket
+        alignas(64) std::array<std::array<float, L1_SIZE>, 2> acc;
+        for (const Color perspective : {Color::WHITE, Color::BLACK})
+        {
+            auto& a = acc[perspective];
+            std::copy_n(&params[FT_BIASES], L1_SIZE, a.begin());
+            for (size_t i = 0; i < entry.feature_count; i++)
+            {
+                const float* row = &params[FT_WEIGHTS + (entry.features[perspective][i] * L1_SIZE)];
+                for (size_t j = 0; j < L1_SIZE; j++)
+                {
+                    a[j] += row[j];
+                }
+            }
+        }
+
+        const Color  us   = entry.stm;
+        const Color  them = colorFlip(us);
+        const float* w    = &params[L1_WEIGHTS + (entry.bucket * 2 * L1_SIZE)];
+
+        float out = params[L1_BIASES + entry.bucket];
+        for (size_t j = 0; j < L1_SIZE; j++)
+        {
+            out += (screlu(acc[us][j]) * w[j]) + (screlu(acc[them][j]) * w[L1_SIZE + j]);
+        }
+
+        // Loss against the game result, seen from the side to move
+        const double sig    = sigmoid(K, out * SCALE);
+        const double target = (us == Color::WHITE) ? entry.wdl : 1.0 - entry.wdl;
+        const double err    = sig - target;
+        g.loss += err * err;
+
+        // Backprop
+        const float grad_out = static_cast<float>(2 * err * sig * (1 - sig) * K * SCALE / 400.0);
+
+        g.values[L1_BIASES + entry.bucket] += grad_out;
+
+        float* grad_w  = &g.values[L1_WEIGHTS + (entry.bucket * 2 * L1_SIZE)];
+        float* grad_ft = &g.values[FT_BIASES];
+
+        alignas(64) std::array<float, L1_SIZE> grad_acc;
+        for (size_t side = 0; side < 2; side++)
+        {
+            const Color  perspective = (side == 0) ? us : them;
+            const auto&  a           = acc[perspective];
+            const size_t offset      = side * L1_SIZE;
+
+            for (size_t j = 0; j < L1_SIZE; j++)
+            {
+                grad_w[offset + j] += grad_out * screlu(a[j]);
+                grad_acc[j] =
+                  ((a[j] > 0.0f) && (a[j] < 1.0f)) ? grad_out * w[offset + j] * 2.0f * a[j] : 0.0f;
+                grad_ft[j] += grad_acc[j];
+            }
+
+            // Sparse inputs: only the rows of active features receive a gradient
+            for (size_t i = 0; i < entry.feature_count; i++)
+            {
+                const u16 feature  = entry.features[perspective][i];
+                g.touched[feature] = 1;
+
+                float* row = &g.values[FT_WEIGHTS + (feature * L1_SIZE)];
+                for (size_t j = 0; j < L1_SIZE; j++)
+                {
+                    row[j] += grad_acc[j];
+                }
+            }
+        }
+    }
+
+    static double compute_gradient(ThreadPool&                  pool,
+                                   const size_t                 nthreads,
+                                   std::vector<ThreadGradient>& gradients,
+                                   const std::vector<Entry>&    entries,
+                                   const std::vector<u32>&      indices,
+                                   const size_t                 first,
+                                   const size_t                 last,
+                                   const std::vector<float>&    params,
+                                   const double                 K) {
+        const size_t n = last - first;
+
+        for (size_t tid = 0; tid < nthreads; ++tid)
+        {
+            const size_t start = first + ((tid * n) / nthreads);
+            const size_t end   = first + (((tid + 1) * n) / nthreads);
+
+            pool.enqueue_detach([tid, start, end, &gradients, &entries, &indices, &params, K]() {
+                auto& g = gradients[tid];
+                for (size_t i = start; i < end; ++i)
+                {
+                    update_gradient_single(g, entries[indices[i]], params, K);
+                }
+            });
+        }
+
+        pool.wait_for_tasks();
+
+        double loss = 0.0;
+        for (auto& g : gradients)
+        {
+            loss += g.loss;
+            g.loss = 0.0;
+        }
+
+        return loss;
+    }
+
+    // Reduces the thread gradients and applies Adam, each task owning a range of rows. Thread
+    // gradients are cleared as they are consumed, and sparse rows are only read from the
+    // threads that touched them.
+    static void apply_gradient(ThreadPool&                  pool,
+                               const size_t                 nthreads,
+                               std::vector<ThreadGradient>& gradients,
+                               std::vector<float>&          params,
+                               Optimizer&                   optimizer,
+                               const size_t                 batch_size,
+                               const double                 learning_rate,
+                               const TrainerSettings&       settings) {
+        optimizer.steps++;
+
+        const double bias_correction1 =
+          1.0 - std::pow(settings.beta1, static_cast<double>(optimizer.steps));
+        const double bias_correction2 =
+          1.0 - std::pow(settings.beta2, static_cast<double>(optimizer.steps));
+
+        const float beta1 = static_cast<float>(settings.beta1);
+        const float beta2 = static_cast<float>(settings.beta2);
+        const float step  = static_cast<float>(learning_rate / bias_correction1);
+        const float vcorr = static_cast<float>(1.0 / bias_correction2);
+        const float scale = 1.0f / static_cast<float>(batch_size);
+
+        for (size_t tid = 0; tid < nthreads; ++tid)
+        {
+            const size_t start = (tid * N_ROWS) / nthreads;
+            const size_t end   = ((tid + 1) * N_ROWS) / nthreads;
+
+            pool.enqueue_detach([=, &gradients, &params, &optimizer]() {
+                alignas(64) std::array<float, L1_SIZE> grad;
+                for (size_t row = start; row < end; ++row)
+                {
+                    const size_t begin = row * L1_SIZE;
+                    const size_t size  = std::min(L1_SIZE, N_PARAMS - begin);
+
+                    grad.fill(0.0f);
+                    for (auto& g : gradients)
+                    {
+                        if (row < INPUT_SIZE)
+                        {
+                            if (!g.touched[row])
+                            {
+                                continue;
+                            }
+                            g.touched[row] = 0;
+                        }
+                        for (size_t j = 0; j < size; j++)
+                        {
+                            grad[j] += g.values[begin + j];
+                            g.values[begin + j] = 0.0f;
+                        }
+                    }
+
+                    for (size_t j = 0; j < size; j++)
+                    {
+                        const size_t i  = begin + j;
+                        const float  gr = grad[j] * scale;
+
+                        optimizer.momentum[i] = beta1 * optimizer.momentum[i] + (1 - beta1) * gr;
+                        optimizer.velocity[i] =
+                          beta2 * optimizer.velocity[i] + (1 - beta2) * gr * gr;
+
+                        params[i] -= step * optimizer.momentum[i]
+                                   / (1e-8f + std::sqrt(optimizer.velocity[i] * vcorr));
+                        params[i] = std::clamp(params[i], -WEIGHT_CLIP, WEIGHT_CLIP);
+                    }
+                }
+            });
+        }
+
+        pool.wait_for_tasks();
+    }
+
+    static i16 quantize(const float value, const i32 scale) {
+        const long q = std::lround(value * scale);
+        return static_cast<i16>(std::clamp<long>(q, std::numeric_limits<i16>::min(),
+                                                 std::numeric_limits<i16>::max()));
+    }
+
+    static void save_network(const std::vector<float>& params, const std::filesystem::path& path) {
+        const NetworkHeader header{NETWORK_MAGIC, NETWORK_VERSION, KING_BUCKETS, L1_SIZE,
+                                   OUTPUT_BUCKETS};
+
+        // Accumulators are scaled by QA and output weights by QB, so output biases need both
+        std::vector<i16> quantized(N_PARAMS);
+        for (size_t i = 0; i < N_PARAMS; i++)
+        {
+            const i32 scale = (i < L1_WEIGHTS) ? QA : (i < L1_BIASES) ? QB : QA * QB;
+            quantized[i]    = quantize(params[i], scale);
+        }
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Failed to open network file for writing");
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(quantized.data()),
+                   static_cast<std::streamsize>(quantized.size() * sizeof(i16)));
+        file.close();
+
+        if (!loadNetwork(path.string()))
+        {
+            throw std::runtime_error("Written network could not be loaded back");
+        }
+
+        std::cout << "Saved network to " << path << std::endl;
+    }
+
+    static void run(ThreadPool&                  pool,
+                    const size_t                 nthreads,
+                    std::vector<float>&          params,
+                    const std::vector<Entry>&    entries,
+                    const std::filesystem::path& out_path,
+                    const TrainerSettings&       settings) {
+        if (entries.empty())
+            return;
+
+        std::vector<ThreadGradient> gradients(nthreads);
+        Optimizer                   optimizer{};
+
+        std::vector<u32> indices(entries.size());
+        std::iota(indices.begin(), indices.end(), 0);
+        std::mt19937 rng(settings.seed);
+
+        const size_t n          = entries.size();
+        const size_t batch_size = std::max<size_t>(1, settings.batch_size);
+
+        double learning_rate = settings.learning_rate_init;
+
+        for (size_t epoch = 1; epoch <= settings.epochs; epoch++)
+        {
+            std::shuffle(indices.begin(), indices.end(), rng);
+
+            double loss = 0.0;
+            for (size_t first = 0; first < n; first += batch_size)
+            {
+                const size_t last = std::min(first + batch_size, n);
+                loss += compute_gradient(pool, nthreads, gradients, entries, indices, first, last,
+                                         params, settings.K);
+                apply_gradient(pool, nthreads, gradients, params, optimizer, last - first,
+                               learning_rate, settings);
+            }
+
+            std::cout << "Epoch = " << (size_t) epoch << "\tError = " << loss / n
+                      << "\tLearning Rate = " << (double) learning_rate << std::endl;
+
+            if ((settings.save_interval != 0) && (epoch % settings.save_interval == 0)
+                && (epoch != settings.epochs))
+            {
+                std::filesystem::path checkpoint = out_path;
+                checkpoint.replace_filename(out_path.stem().string() + "-e" + std::to_string(epoch)
+                                            + out_path.extension().string());
+                save_network(params, checkpoint);
+            }
+
+            if (epoch % settings.learning_rate_drop_interval == 0)
+            {
+                learning_rate *= settings.learning_rate_drop_ratio;
+            }
+        }
+    }
+
+    void train(const std::filesystem::path& epd_path,
+               const std::filesystem::path& out_path,
+               const TrainerSettings&       settings) {
+        std::cout << "Reading .epd file: " << epd_path << std::endl;
+        std::vector<Entry> entries{};
+        read_epd(entries, epd_path);
+        std::cout << "Found " << (size_t) entries.size() << " Entries" << std::endl;
+
+        std::vector<float> params = init_parameters(settings.seed);
+        std::cout << "No. of Parameters: " << (size_t) N_PARAMS << std::endl;
+
+        std::cout << "Using dp::thread-pool version " << THREADPOOL_VERSION << '\n';
+
+        const size_t nthreads = std::max<size_t>(1, settings.thread_count);
+        std::cout << "Using " << (size_t) nthreads << " threads" << std::endl;
+
+        ThreadPool pool(nthreads);
+
+        std::cout << "Using K = " << (double) settings.K << std::endl;
+
+        std::cout << "Beginning to train" << std::endl;
+        run(pool, nthreads, params, entries, out_path, settings);
+
+        save_network(params, out_path);
+
+        std::cout << "Training complete" << std::endl;
+    }
+
+}
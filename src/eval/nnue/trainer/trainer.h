@@ -0,0 +1,28 @@
+#pragma once
+
+#include "commons/pch.h"
+#include "core/types.h"
+
+namespace sagittar::eval::nnue::trainer {
+
+    struct TrainerSettings {
+        double K                           = 1.0;
+        size_t epochs                      = 40;
+        size_t batch_size                  = 16384;
+        double beta1                       = 0.9;
+        double beta2                       = 0.999;
+        double learning_rate_init          = 0.001;
+        size_t learning_rate_drop_interval = 15;
+        double learning_rate_drop_ratio    = 0.3;
+        size_t save_interval               = 10;  // Epochs between checkpoints
+        u32    seed                        = 0;
+        size_t thread_count                = std::max(1u, std::thread::hardware_concurrency());
+    };
+
+    // Trains a network from scratch on an .epd dataset in the tuner's format and writes it,
+    // quantized, to out_path
+    void train(const std::filesystem::path& epd_path,
+               const std::filesystem::path& out_path,
+               const TrainerSettings&       settings);
+
+}
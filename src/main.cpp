@@ -16,12 +16,23 @@ int main(int argc, char* argv[]) {
         {
             engine.bench();
         }
+        else if (cmd == "tbgen" && argc >= 4)
+        {
+            const std::vector<std::string> materials(argv + 3, argv + argc);
+            return engine.generateTablebases(argv[2], materials) ? 0 : 1;
+        }
 #ifdef EXTERNAL_TUNE
         else if (cmd == "tune")
         {
             const std::filesystem::path data_path = argv[2];
             engine.tune(data_path);
         }
+        else if (cmd == "train" && argc >= 4)
+        {
+            const std::filesystem::path data_path = argv[2];
+            const std::filesystem::path out_path  = argv[3];
+            engine.train(data_path, out_path);
+        }
 #endif
     }
     return 0;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "commons/pch.h"
+#include "core/move.h"
 #include "core/types.h"
 
 namespace sagittar::search {
@@ -9,4 +10,24 @@ namespace sagittar::search {
 
     using PieceToHistory = std::array<std::array<i16, 64>, 15>;
 
+    // Indexed by the previous move's [piece][to], yields a PieceToHistory for the current move
+    using ContinuationHistory = std::array<std::array<PieceToHistory, 64>, 15>;
+
+    // [piece][to][captured piece type]
+    using CaptureHistory = std::array<std::array<std::array<i16, 6>, 64>, 15>;
+
+    using CounterMoveTable = std::array<std::array<Move, 64>, 15>;  // [piece][to]
+
+    // Continuation histories of the moves played 1 and 2 plies ago
+    using ContHistEntries = std::array<const PieceToHistory*, 2>;
+
+    // Static eval correction, learnt from the difference between search score and static eval.
+    // Entries are stored with a fixed-point grain and indexed by [stm][key % size].
+    static constexpr i32         CORRECTION_HISTORY_GRAIN        = 256;
+    static constexpr i32         CORRECTION_HISTORY_WEIGHT_SCALE = 256;
+    static constexpr i32         CORRECTION_HISTORY_MAX          = CORRECTION_HISTORY_GRAIN * 32;
+    static constexpr std::size_t CORRECTION_HISTORY_SIZE         = 16384;
+
+    using CorrectionHistory = std::array<std::array<i16, CORRECTION_HISTORY_SIZE>, 2>;
+
 }
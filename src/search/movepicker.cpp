@@ -33,40 +33,64 @@ namespace sagittar::search {
         return a.move.id() < b.move.id();
     };
 
-    constexpr i16 MVVLVA_SCORE_OFFSET = 10000;
-
-    MovePicker::MovePicker(ExtMove*              buffer,
-                           const Position&       pos,
-                           const Move&           ttmove,
-                           const PieceToHistory& history,
-                           const Move&           killer1,
-                           const Move&           killer2,
-                           const MovegenType     type) {
-        process(buffer, pos, ttmove, history, killer1, killer2, type);
+    constexpr i32 MVVLVA_SCORE_OFFSET = 10000;
+
+    // Capture history is blended in at a scale where it can reorder captures of the same victim,
+    // but can not lift a pawn capture above a queen capture.
+    constexpr i32 MVVLVA_WEIGHT    = 32;
+    constexpr i32 CAPTHIST_DIVISOR = 16;
+
+    // Quiets moving a piece out of an attack by a less valuable piece are tried earlier, quiets
+    // moving it into one later
+    static constexpr std::array<i32, 6> THREAT_SCORES = {0, 4096, 4096, 8192, 12288, 0};
+
+    template<Color US>
+    MovePicker<US>::MovePicker(ExtMove*               buffer,
+                               const Position&        pos,
+                               const Move&            ttmove,
+                               const PieceToHistory&  history,
+                               const ContHistEntries& cont_hist,
+                               const CaptureHistory&  capt_history,
+                               const Move&            killer1,
+                               const Move&            killer2,
+                               const Move&            counter,
+                               const MovegenType      type) {
+        process(buffer, pos, ttmove, history, cont_hist, capt_history, killer1, killer2, counter,
+                type);
     }
 
-    void MovePicker::process(ExtMove*              buffer,
-                             const Position&       pos,
-                             const Move&           ttmove,
-                             const PieceToHistory& history,
-                             const Move&           killer1,
-                             const Move&           killer2,
-                             const MovegenType     type) {
+    template<Color US>
+    void MovePicker<US>::process(ExtMove*               buffer,
+                                 const Position&        pos,
+                                 const Move&            ttmove,
+                                 const PieceToHistory&  history,
+                                 const ContHistEntries& cont_hist,
+                                 const CaptureHistory&  capt_history,
+                                 const Move&            killer1,
+                                 const Move&            killer2,
+                                 const Move&            counter,
+                                 const MovegenType      type) {
         // Generate pseudolegal moves
         containers::ArrayList<Move> moves;
 
         switch (type)
         {
             case MovegenType::ALL :
-                pseudolegalMoves<MovegenType::ALL>(&moves, pos);
+                pseudolegalMoves<US, MovegenType::ALL>(&moves, pos);
                 break;
 
             case MovegenType::CAPTURES :
-                pseudolegalMoves<MovegenType::CAPTURES>(&moves, pos);
+                pseudolegalMoves<US, MovegenType::CAPTURES>(&moves, pos);
                 break;
 
             case MovegenType::CHECK_EVASIONS :
-                pseudolegalMoves<MovegenType::CHECK_EVASIONS>(&moves, pos);
+                pseudolegalMoves<US, MovegenType::CHECK_EVASIONS>(&moves, pos);
+                break;
+
+            case MovegenType::QUIET_CHECKS :
+                // Captures first, then the quiet checks
+                pseudolegalMoves<US, MovegenType::CAPTURES>(&moves, pos);
+                pseudolegalMoves<US, MovegenType::QUIET_CHECKS>(&moves, pos);
                 break;
 
             default :
@@ -90,17 +114,17 @@ namespace sagittar::search {
 
             if (move.isCapture())
             {
-                const PieceType attacker = pieceTypeOf(pos.pieceOn(move.from()));
-                const PieceType victim   = (move.flag() == MoveFlag::MOVE_CAPTURE_EP)
-                                           ? PieceType::PAWN
-                                           : pieceTypeOf(pos.pieceOn(move.to()));
+                const Piece     piece    = pos.pieceOn(move.from());
+                const PieceType attacker = pieceTypeOf(piece);
+                const PieceType victim   = capturedPieceType(pos, move);
                 const auto      idx      = mvvlvaIdx(attacker, victim);
-                const auto      score = static_cast<i16>(MVV_LVA_TABLE[idx] + MVVLVA_SCORE_OFFSET);
+                const i32       score    = MVVLVA_SCORE_OFFSET + MVV_LVA_TABLE[idx] * MVVLVA_WEIGHT
+                                + capt_history[piece][move.to()][victim] / CAPTHIST_DIVISOR;
                 buffer[capture_count++] = ExtMove{move, score};
             }
         }
 
-        // Process Killer moves and Quites
+        // Process Killer moves, Counter move and Quites
 
         ExtMove* quiet_ptr = buffer + capture_count;
 
@@ -119,11 +143,32 @@ namespace sagittar::search {
             {
                 m_killers[1] = move;
             }
+            else if (move == counter)
+            {
+                m_counter = move;
+            }
             else
             {
-                const Piece piece = pos.pieceOn(move.from());
-                const auto  score = history[piece][move.to()];
-                *quiet_ptr++      = ExtMove{move, score};
+                const Piece     piece = pos.pieceOn(move.from());
+                const PieceType pt    = pieceTypeOf(piece);
+                const Square    to    = move.to();
+                i32             score =
+                  history[piece][to] + (*cont_hist[0])[piece][to] + (*cont_hist[1])[piece][to];
+
+                if (THREAT_SCORES[pt])
+                {
+                    const BitBoard threats = pos.lowerValueThreats(US, pt);
+                    if (threats & BB(move.from()))
+                    {
+                        score += THREAT_SCORES[pt];
+                    }
+                    if (threats & BB(to))
+                    {
+                        score -= THREAT_SCORES[pt];
+                    }
+                }
+
+                *quiet_ptr++ = ExtMove{move, score};
             }
         }
 
@@ -139,13 +184,23 @@ namespace sagittar::search {
         m_it_quiets = m_quiets.data();
     }
 
-    size_t MovePicker::size() const { return m_moves_count; }
+    template<Color US>
+    size_t MovePicker<US>::size() const {
+        return m_moves_count;
+    }
 
-    MovePickerPhase MovePicker::phase() const { return m_phase; }
+    template<Color US>
+    MovePickerPhase MovePicker<US>::phase() const {
+        return m_phase;
+    }
 
-    bool MovePicker::hasNext() const { return (m_index < m_moves_count); }
+    template<Color US>
+    bool MovePicker<US>::hasNext() const {
+        return (m_index < m_moves_count);
+    }
 
-    Move MovePicker::next() {
+    template<Color US>
+    Move MovePicker<US>::next() {
         switch (m_phase)
         {
             case MovePickerPhase::TT_MOVE : {
@@ -178,6 +233,18 @@ namespace sagittar::search {
                         return move;
                     }
                 }
+                m_phase = MovePickerPhase::COUNTER_MOVE;
+                [[fallthrough]];
+            }
+
+            case MovePickerPhase::COUNTER_MOVE : {
+                if (m_counter != NULL_MOVE)
+                {
+                    const Move move = m_counter;
+                    m_counter       = NULL_MOVE;
+                    ++m_index;
+                    return move;
+                }
                 m_phase = MovePickerPhase::QUIETS;
                 [[fallthrough]];
             }
@@ -200,4 +267,7 @@ namespace sagittar::search {
         }
     }
 
+    template class MovePicker<Color::WHITE>;
+    template class MovePicker<Color::BLACK>;
+
 }
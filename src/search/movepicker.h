@@ -15,20 +15,30 @@ namespace sagittar::search {
         TT_MOVE,
         CAPTURES,
         KILLERS,
+        COUNTER_MOVE,
         QUIETS,
         DONE
     };
 
+    inline PieceType capturedPieceType(const Position& pos, const Move& move) {
+        return (move.flag() == MoveFlag::MOVE_CAPTURE_EP) ? PieceType::PAWN
+                                                           : pieceTypeOf(pos.pieceOn(move.to()));
+    }
+
+    template<Color US>
     class MovePicker final {
        public:
         MovePicker() = delete;
-        explicit MovePicker(ExtMove*              buffer,
-                            const Position&       pos,
-                            const Move&           ttmove,
-                            const PieceToHistory& history,
-                            const Move&           killer1,
-                            const Move&           killer2,
-                            const MovegenType     type);
+        explicit MovePicker(ExtMove*               buffer,
+                            const Position&        pos,
+                            const Move&            ttmove,
+                            const PieceToHistory&  history,
+                            const ContHistEntries& cont_hist,
+                            const CaptureHistory&  capt_history,
+                            const Move&            killer1,
+                            const Move&            killer2,
+                            const Move&            counter,
+                            const MovegenType      type);
         MovePicker(const MovePicker&)                = delete;
         MovePicker(MovePicker&&) noexcept            = delete;
         MovePicker& operator=(const MovePicker&)     = delete;
@@ -43,13 +53,16 @@ namespace sagittar::search {
         Move            next();
 
        private:
-        void process(ExtMove*              buffer,
-                     const Position&       pos,
-                     const Move&           ttmove,
-                     const PieceToHistory& history,
-                     const Move&           killer1,
-                     const Move&           killer2,
-                     const MovegenType     type);
+        void process(ExtMove*               buffer,
+                     const Position&        pos,
+                     const Move&            ttmove,
+                     const PieceToHistory&  history,
+                     const ContHistEntries& cont_hist,
+                     const CaptureHistory&  capt_history,
+                     const Move&            killer1,
+                     const Move&            killer2,
+                     const Move&            counter,
+                     const MovegenType      type);
 
         size_t m_moves_count{0};
 
@@ -60,6 +73,7 @@ namespace sagittar::search {
 
         Move                m_tt_move{};
         std::array<Move, 2> m_killers{};
+        Move                m_counter{};
 
         MovePickerPhase m_phase{MovePickerPhase::TT_MOVE};
 
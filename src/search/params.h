@@ -66,6 +66,10 @@ namespace sagittar::search::params {
     void updateLMPTresholdPct();
     void updateLMRTable();
 
+    PARAM(aspiration_depth_min, 2, 1, 8, 1);
+    PARAM(aspiration_delta, 30, 10, 200, 5);
+    PARAM(aspiration_widening_pct, 50, 10, 200, 10);
+
     PARAM(rfp_margin, 51, 50, 1000, 25);
 
     PARAM_CALLBACK(lmp_treshold, 9, 1, 9, 1, updateLMPTresholdPct);
@@ -78,4 +82,15 @@ namespace sagittar::search::params {
     PARAM(futility_margin_c, 9, 5, 500, 5);
     PARAM(futility_margin_m, 143, 0, 1000, 10);
 
+    PARAM(probcut_depth_min, 5, 3, 10, 1);
+    PARAM(probcut_margin, 200, 50, 500, 10);
+    PARAM(probcut_reduction, 4, 2, 6, 1);
+
+    PARAM(qs_delta_margin, 200, 0, 1000, 25);
+    PARAM(lazy_eval_margin, 400, 100, 1500, 50);
+    PARAM(qs_quiet_checks, 1, 0, 1, 1);
+
+    PARAM(se_depth_min, 8, 4, 12, 1);
+    PARAM(se_margin, 2, 1, 8, 1);
+
 }
@@ -2,12 +2,65 @@
 #include "commons/utils.h"
 #include "core/movegen.h"
 #include "eval/hce/eval.h"
+#include "eval/nnue/nnue.h"
 #include "search/movepicker.h"
 #include "search/params.h"
+#include "search/see.h"
 #include "search/timeman.h"
+#include "tb/tablebase.h"
 
 namespace sagittar::search {
 
+    namespace {
+
+        // Exact, with the mate distance counted from the root
+        Score tablebaseScore(const tb::ProbeResult& result, const i32 ply) {
+            switch (result.wdl)
+            {
+                case tb::WDL::WIN :
+                    return MATE_VALUE - (ply + result.plies);
+                case tb::WDL::LOSS :
+                    return -MATE_VALUE + ply + result.plies;
+                default :
+                    return 0;
+            }
+        }
+
+        // The move keeping the best mate distance. False unless every legal move reaches a table.
+        template<Color US>
+        bool probeRoot(const Position& pos, Move* best_move, Score* best_score) {
+            containers::ArrayList<Move> moves;
+            pseudolegalMoves<US, MovegenType::ALL>(&moves, pos);
+
+            bool found  = false;
+            *best_score = -INF;
+            for (const Move& move : moves)
+            {
+                Position child = pos;
+                if (!child.doMove<US>(move))
+                {
+                    continue;
+                }
+
+                tb::ProbeResult result;
+                if (!tb::probe(child, &result))
+                {
+                    return false;
+                }
+
+                const Score score = -tablebaseScore(result, 1);
+                if (score > *best_score)
+                {
+                    *best_score = score;
+                    *best_move  = move;
+                    found       = true;
+                }
+            }
+            return found;
+        }
+
+    }
+
     Searcher::Searcher() :
         n_threads(1) {
         reset();
@@ -15,7 +68,7 @@ namespace sagittar::search {
 
     void Searcher::reset() {
         workers.clear();
-        tt.clear();
+        clearEvalCaches();
     }
 
     void Searcher::resetForSearch() {
@@ -27,8 +80,24 @@ namespace sagittar::search {
 
     void Searcher::setThreadCount(const std::size_t n) { n_threads = n; }
 
+    void Searcher::setUseNNUE(const bool enable) {
+        use_nnue = enable;
+        clearEvalCaches();
+    }
+
+    void Searcher::setEvalCacheSize(const std::size_t mb) { eval_cache_size = mb; }
+
+    void Searcher::clearEvalCaches() {
+        // TT entries keep the raw static eval as well, reused in place of evaluating again
+        tt.clear();
+        for (auto& c : caches)
+        {
+            c->eval.clear();
+        }
+    }
+
     SearchResult Searcher::startSearch(const Position&                          pos,
-                                       std::span<u64>                           key_history,
+                                       std::span<const u64>                     key_history,
                                        SearchInfo                               info,
                                        std::function<void(const SearchResult&)> onProgress,
                                        std::function<void(const SearchResult&)> onComplete) {
@@ -37,9 +106,25 @@ namespace sagittar::search {
         workers.clear();
         workers.reserve(n_threads);
 
+        while (caches.size() < n_threads)
+        {
+            caches.emplace_back(std::make_unique<ThreadCaches>());
+        }
+
+        // Probed once here, every iteration of every worker plays the same move
+        RootTablebase root_tablebase{};
+        if (pos.occupied().count() <= tb::maxPieces())
+        {
+            root_tablebase.solved =
+              (pos.stm() == Color::WHITE)
+                ? probeRoot<Color::WHITE>(pos, &root_tablebase.move, &root_tablebase.score)
+                : probeRoot<Color::BLACK>(pos, &root_tablebase.move, &root_tablebase.score);
+        }
+
         for (size_t i = 0; i < n_threads; i++)
         {
-            workers.emplace_back(std::make_unique<Worker>(key_history, info, tt));
+            workers.emplace_back(std::make_unique<Worker>(key_history, info, tt, *caches[i],
+                                                          root_tablebase, use_nnue));
         }
 
         std::vector<std::future<SearchResult>> futures;
@@ -51,6 +136,14 @@ namespace sagittar::search {
               std::launch::async, [this, id, &pos, onProgress, onComplete]() -> SearchResult {
                   Worker& w = *workers[id];
 
+                  // Allocated from the thread that uses them, so their pages are local to it
+                  ThreadCaches& c = *caches[id];
+                  if (c.eval.getSize() != eval_cache_size)
+                  {
+                      c.eval.setSize(eval_cache_size);
+                  }
+                  c.hce.allocate();
+
                   if (id == 0)
                   {
                       // Main thread
@@ -80,7 +173,7 @@ namespace sagittar::search {
     }
 
     SearchResult
-    Searcher::startSearch(const Position& pos, std::span<u64> key_history, SearchInfo info) {
+    Searcher::startSearch(const Position& pos, std::span<const u64> key_history, SearchInfo info) {
         return startSearch(pos, key_history, info, [](auto&) {}, [](auto&) {});
     }
 
@@ -94,15 +187,18 @@ namespace sagittar::search {
         }
     }
 
-    Searcher::Worker::Worker(std::span<u64>      key_history_ptr,
-                             const SearchInfo&   info,
-                             TranspositionTable& tt) :
+    Searcher::Worker::Worker(std::span<const u64> game_history,
+                             const SearchInfo&    info,
+                             TranspositionTable&  tt,
+                             ThreadCaches&        caches,
+                             const RootTablebase& root_tablebase,
+                             const bool           use_nnue) :
+        key_history(game_history),
         info(info),
-        tt(tt) {
-        key_history.reserve(1024);
-        key_history.clear();
-        std::ranges::copy(key_history_ptr, std::back_inserter(key_history));
-    }
+        tt(tt),
+        caches(caches),
+        root_tablebase(root_tablebase),
+        use_nnue(use_nnue) {}
 
     void Searcher::Worker::checkTimeUp() {
         if (info.timeset && (utils::currtimeInMilliseconds() >= info.stoptime))
@@ -111,65 +207,185 @@ namespace sagittar::search {
         }
     }
 
-    bool Searcher::Worker::doMove(Position& pos, const Move& move) {
-        key_history.push_back(pos.key());
-        return pos.doMove(move);
+    template<Color US>
+    bool Searcher::Worker::doMove(Position& pos, const Move& move, const i32 ply) {
+        key_history.push(pos.key());
+
+        if (!use_nnue)
+        {
+            return pos.doMove<US>(move);
+        }
+
+        const Piece moved    = pos.pieceOn(move.from());
+        const Piece captured = pos.pieceOn(move.to());
+        if (!pos.doMove<US>(move))
+        {
+            return false;
+        }
+        eval::nnue::update(accumulators[ply + 1], accumulators[ply], pos, move, moved, captured);
+        return true;
     }
 
-    void Searcher::Worker::doNullMove(Position& pos) {
-        key_history.push_back(pos.key());
+    void Searcher::Worker::doNullMove(Position& pos, const i32 ply) {
+        key_history.push(pos.key());
         pos.doNullMove();
+        if (use_nnue)
+        {
+            accumulators[ply + 1] = accumulators[ply];
+        }
     }
 
-    void Searcher::Worker::undoMove() { key_history.pop_back(); }
-
-    void Searcher::Worker::undoNullMove() { key_history.pop_back(); }
+    template<Color US>
+    Score Searcher::Worker::evaluate(const Position& pos, const i32 ply) {
+        Score eval;
+        if (caches.eval.probe(pos.key(), &eval))
+        {
+            return eval;
+        }
 
-    void Searcher::Worker::updateHistory(const Piece p, const Square to, const i32 bonus) {
-        const auto clamped_bonus = std::clamp<i16>(bonus, -MAX_HISTORY, MAX_HISTORY);
-        history[p][to] += clamped_bonus - history[p][to] * std::abs(clamped_bonus) / MAX_HISTORY;
+        eval = use_nnue ? eval::nnue::evaluate<US>(pos, accumulators[ply])
+                        : eval::hce::evaluate<US>(pos, caches.hce);
+        caches.eval.store(pos.key(), eval);
+        return eval;
     }
 
-    SearchResult Searcher::Worker::start(const Position&                          pos,
-                                         std::function<void(const SearchResult&)> onProgress,
-                                         std::function<void(const SearchResult&)> onComplete) {
-        SearchResult bestresult{};
+    template<Color US>
+    Score Searcher::Worker::evaluateLazy(
+      const Position& pos, const i32 ply, const Score alpha, const Score beta, bool* is_lazy) {
+        *is_lazy = false;
 
-        Score alpha = -INF;
-        Score beta  = INF;
+        if (use_nnue)
+        {
+            return evaluate<US>(pos, ply);
+        }
 
-        for (Depth currdepth = 1; currdepth <= info.depth; currdepth++)
+        Score eval;
+        if (caches.eval.probe(pos.key(), &eval))
         {
-            nodes = 0;
+            return eval;
+        }
 
-            const u64 starttime = utils::currtimeInMilliseconds();
-            Score     score     = search<NodeType::ROOT>(pos, currdepth, alpha, beta, 0, true);
-            const u64 time      = utils::currtimeInMilliseconds() - starttime;
+        const eval::hce::LazyWindow window{alpha, beta, params::lazy_eval_margin()};
+        eval = eval::hce::evaluate<US>(pos, caches.hce, window, is_lazy);
+        if (!*is_lazy)
+        {
+            caches.eval.store(pos.key(), eval);
+        }
+        return eval;
+    }
 
-            if (should_stop.load(std::memory_order_relaxed))
-            {
-                break;
-            }
+    void Searcher::Worker::undoMove() { key_history.pop(); }
 
-            // Aspiration Windows
-            if ((score <= alpha) || (score >= beta))
+    void Searcher::Worker::undoNullMove() { key_history.pop(); }
+
+    void Searcher::Worker::updateHistory(PieceToHistory& table,
+                                         const Piece     p,
+                                         const Square    to,
+                                         const i32       bonus) {
+        const auto clamped_bonus = std::clamp<i16>(bonus, -MAX_HISTORY, MAX_HISTORY);
+        table[p][to] += clamped_bonus - table[p][to] * std::abs(clamped_bonus) / MAX_HISTORY;
+    }
+
+    void Searcher::Worker::updateQuietHistories(const i32    ply,
+                                                const Piece  p,
+                                                const Square to,
+                                                const i32    bonus) {
+        updateHistory(history, p, to, bonus);
+
+        // Continuation History (1-ply and 2-ply)
+        for (i32 i = 1; i <= 2 && ply >= i; i++)
+        {
+            const StackEntry& prev = stack[ply - i];
+            if (prev.piece != Piece::NO_PIECE)
             {
-                // We fell outside the window
-                // Try again with a full-width window (and the same depth).
-                alpha = -INF;
-                beta  = INF;
-                currdepth--;
-                continue;
+                updateHistory(cont_history[prev.piece][prev.move.to()], p, to, bonus);
             }
-            else
+        }
+    }
+
+    void Searcher::Worker::updateCaptureHistory(const Position& pos,
+                                                const Move&     move,
+                                                const i32       bonus) {
+        const Piece     piece         = pos.pieceOn(move.from());
+        const PieceType captured      = capturedPieceType(pos, move);
+        const auto      clamped_bonus = std::clamp<i16>(bonus, -MAX_HISTORY, MAX_HISTORY);
+        i16&            entry         = capt_history[piece][move.to()][captured];
+        entry += clamped_bonus - entry * std::abs(clamped_bonus) / MAX_HISTORY;
+    }
+
+    void Searcher::Worker::updateCorrectionHistory(const Position& pos,
+                                                   const Depth     depth,
+                                                   const Score     diff) {
+        const Color stm    = pos.stm();
+        const i32   scaled = diff * CORRECTION_HISTORY_GRAIN;
+        const i32   weight = std::min(depth + 1, 16);
+
+        const auto update = [&](i16& entry) {
+            const i32 value = (entry * (CORRECTION_HISTORY_WEIGHT_SCALE - weight) + scaled * weight)
+                            / CORRECTION_HISTORY_WEIGHT_SCALE;
+            entry = static_cast<i16>(
+              std::clamp(value, -CORRECTION_HISTORY_MAX, CORRECTION_HISTORY_MAX));
+        };
+
+        update(pawn_corrhist[stm][pos.pawn_key() % CORRECTION_HISTORY_SIZE]);
+        update(non_pawn_corrhist[Color::WHITE][stm]
+                                [pos.non_pawn_key(Color::WHITE) % CORRECTION_HISTORY_SIZE]);
+        update(non_pawn_corrhist[Color::BLACK][stm]
+                                [pos.non_pawn_key(Color::BLACK) % CORRECTION_HISTORY_SIZE]);
+    }
+
+    Score Searcher::Worker::correctStaticEval(const Position& pos, const Score raw_eval) const {
+        const Color stm = pos.stm();
+
+        const i32 correction =
+          pawn_corrhist[stm][pos.pawn_key() % CORRECTION_HISTORY_SIZE]
+          + non_pawn_corrhist[Color::WHITE][stm]
+                             [pos.non_pawn_key(Color::WHITE) % CORRECTION_HISTORY_SIZE]
+          + non_pawn_corrhist[Color::BLACK][stm]
+                             [pos.non_pawn_key(Color::BLACK) % CORRECTION_HISTORY_SIZE];
+
+        // Each table learns the full error, so use their average
+        const Score corrected = raw_eval + correction / (3 * CORRECTION_HISTORY_GRAIN);
+
+        return std::clamp(corrected, -WIN_SCORE + 1, WIN_SCORE - 1);
+    }
+
+    ContHistEntries Searcher::Worker::contHistEntries(const i32 ply) const {
+        // Moves without a predecessor (root, after a null move) use the NO_PIECE slot,
+        // which is never updated.
+        const auto entry = [&](const i32 i) -> const PieceToHistory* {
+            if (ply < i)
             {
-                alpha = score - 50;
-                beta  = score + 50;
+                return &cont_history[Piece::NO_PIECE][0];
             }
+            const StackEntry& prev = stack[ply - i];
+            return &cont_history[prev.piece][prev.move.to()];
+        };
+
+        return {entry(1), entry(2)};
+    }
+
+    Move Searcher::Worker::counterMove(const i32 ply) const {
+        if (ply < 1)
+        {
+            return NULL_MOVE;
+        }
+        const StackEntry& prev = stack[ply - 1];
+        return (prev.piece == Piece::NO_PIECE) ? NULL_MOVE
+                                               : counter_moves[prev.piece][prev.move.to()];
+    }
+
+    SearchResult Searcher::Worker::start(const Position&                          pos,
+                                         std::function<void(const SearchResult&)> onProgress,
+                                         std::function<void(const SearchResult&)> onComplete) {
+        SearchResult bestresult{};
 
+        const auto makeResult = [&](const Score score, const Depth depth, const ScoreBound bound,
+                                    const u64 time) {
             SearchResult result{};
 
             result.score = score;
+            result.bound = bound;
             if (score > -MATE_VALUE && score < -MATE_SCORE)
             {
                 result.is_mate = true;
@@ -185,13 +401,92 @@ namespace sagittar::search {
                 result.is_mate = false;
                 result.mate_in = 0;
             }
-            result.depth    = currdepth;
+            result.depth    = depth;
             result.nodes    = nodes;
             result.time     = time;
             result.hashfull = tt.hashfull();
             result.bestmove = pvmove;
             result.pv       = {result.bestmove};
 
+            return result;
+        };
+
+        if (use_nnue)
+        {
+            eval::nnue::refresh(accumulators[0], pos);
+        }
+
+        Score score = 0;
+
+        for (Depth currdepth = 1; currdepth <= info.depth; currdepth++)
+        {
+            nodes = 0;
+
+            // Aspiration Windows
+            // Start with a narrow window around the previous score, and widen it gradually
+            // on the failing side only.
+            Score delta = params::aspiration_delta();
+            Score alpha = -INF;
+            Score beta  = INF;
+            if (currdepth >= params::aspiration_depth_min())
+            {
+                alpha = std::max<Score>(score - delta, -INF);
+                beta  = std::min<Score>(score + delta, INF);
+            }
+
+            Depth search_depth = currdepth;
+
+            const u64 starttime = utils::currtimeInMilliseconds();
+
+            while (true)
+            {
+                score =
+                  (pos.stm() == Color::WHITE)
+                    ? search<Color::WHITE, NodeType::ROOT>(pos, search_depth, alpha, beta, 0, true)
+                    : search<Color::BLACK, NodeType::ROOT>(pos, search_depth, alpha, beta, 0, true);
+
+                if (should_stop.load(std::memory_order_relaxed))
+                {
+                    break;
+                }
+
+                ScoreBound bound;
+
+                if (score <= alpha)
+                {
+                    // Fail low: pull beta towards the window and search at full depth again
+                    bound        = ScoreBound::UPPERBOUND;
+                    beta         = (alpha + beta) / 2;
+                    alpha        = std::max<Score>(score - delta, -INF);
+                    search_depth = currdepth;
+                }
+                else if (score >= beta)
+                {
+                    // Fail high: the move is likely good, verify it at a slightly lower depth
+                    bound        = ScoreBound::LOWERBOUND;
+                    beta         = std::min<Score>(score + delta, INF);
+                    search_depth = std::max<Depth>(search_depth - 1, 1);
+                }
+                else
+                {
+                    break;
+                }
+
+                const u64 time = utils::currtimeInMilliseconds() - starttime;
+                onProgress(makeResult(score, currdepth, bound, time));
+
+                delta += delta * params::aspiration_widening_pct() / 100;
+            }
+
+            const u64 time = utils::currtimeInMilliseconds() - starttime;
+
+            if (should_stop.load(std::memory_order_relaxed))
+            {
+                break;
+            }
+
+            const SearchResult result = makeResult(score, currdepth, ScoreBound::EXACT, time);
+
             onProgress(result);
 
             bestresult = result;
@@ -204,7 +499,7 @@ namespace sagittar::search {
 
     void Searcher::Worker::stop() { should_stop.store(true, std::memory_order_relaxed); }
 
-    template<Searcher::Worker::NodeType nodeType>
+    template<Color US, Searcher::Worker::NodeType nodeType>
     Score Searcher::Worker::search(const Position& pos,
                                    Depth           depth,
                                    Score           alpha,
@@ -212,6 +507,8 @@ namespace sagittar::search {
                                    const i32       ply,
                                    const bool      do_null) {
 
+        constexpr Color THEM = colorFlip(US);
+
         constexpr bool is_root_node    = (nodeType == NodeType::ROOT);
         constexpr bool is_pv_node_type = (nodeType != NodeType::NON_PV);
         const bool     is_pv_node      = ((beta - alpha) > 1) || is_pv_node_type;
@@ -229,13 +526,47 @@ namespace sagittar::search {
 
             if (ply >= MAX_DEPTH - 1) [[unlikely]]
             {
-                return eval::hce::evaluate(pos);
+                return evaluate<US>(pos, ply);
             }
 
             if ((do_null && pos.isDrawn(key_history)) || (pos.halfmoves() >= 100))
             {
                 return 0;
             }
+
+            // Upcoming Repetition
+            // A move exists that repeats an earlier position of this line, so the draw
+            // score is the least we can get
+            if (alpha < 0 && pos.hasUpcomingRepetition(key_history, ply))
+            {
+                alpha = 0;
+                if (alpha >= beta)
+                {
+                    return alpha;
+                }
+            }
+
+            // Bitbase endgames are solved, whatever the depth left
+            if (pos.occupied().count() <= 3 && caches.hce.material.probe(pos).evaluator.exact)
+            {
+                return eval::hce::evaluate<US>(pos, caches.hce);
+            }
+
+            // Tablebase positions are solved, mate distance included
+            tb::ProbeResult result;
+            if (pos.occupied().count() <= tb::maxPieces() && tb::probe(pos, &result))
+            {
+                return tablebaseScore(result, ply);
+            }
+        }
+        else
+        {
+            // A solved root needs no search, the tables give the best move
+            if (root_tablebase.solved)
+            {
+                pvmove = root_tablebase.move;
+                return root_tablebase.score;
+            }
         }
 
         const bool is_in_check = pos.isInCheck();
@@ -247,16 +578,21 @@ namespace sagittar::search {
 
         if (depth <= 0)
         {
-            return quiescencesearch(pos, alpha, beta, ply);
+            return quiescencesearch<US>(pos, 0, alpha, beta, ply);
         }
 
         const bool is_critical_node = is_pv_node || is_in_check;
 
+        // Singular extension search, excluding the TT move of this very node
+        const Move excluded_move   = stack[ply].excluded;
+        const bool is_singular_ext = (excluded_move != NULL_MOVE);
+
         TTData     ttdata;
         const bool tthit = tt.probe(&ttdata, pos.key());
+        const bool tt_pv = is_pv_node || (tthit && ttdata.pv);
 
         // TT cutoff
-        if (!is_pv_node && tthit && ttdata.depth >= depth)
+        if (!is_pv_node && !is_singular_ext && tthit && ttdata.depth >= depth)
         {
             Score ttscore = ttdata.score;
             if (ttscore < -MATE_SCORE)
@@ -278,10 +614,19 @@ namespace sagittar::search {
 
         bool do_futility_pruning = false;
 
-        if (!is_critical_node)
+        Score raw_eval    = EVAL_NONE;
+        Score static_eval = -INF;
+
+        if (!is_in_check)
         {
-            const Score static_eval = eval::hce::evaluate(pos);
+            // Reuse the static eval from the TT, it is stored uncorrected
+            raw_eval =
+              (tthit && ttdata.eval != EVAL_NONE) ? ttdata.eval : evaluate<US>(pos, ply);
+            static_eval = correctStaticEval(pos, raw_eval);
+        }
 
+        if (!is_critical_node && !is_singular_ext)
+        {
             // Reverse Futility Pruning
             if (depth <= 8)
             {
@@ -293,14 +638,18 @@ namespace sagittar::search {
             }
 
             // Null Move Pruning
-            if (do_null && depth >= 3 && !eval::hce::isEndGame(pos))
+            if (do_null && depth >= 3 && static_eval >= beta
+                && !caches.hce.material.probe(pos).endgame)
             {
                 u8 r = 2;
                 r += (depth > 7);
+                stack[ply].move   = NULL_MOVE;
+                stack[ply].piece  = Piece::NO_PIECE;
                 Position pos_copy = pos;
-                doNullMove(pos_copy);
+                doNullMove(pos_copy, ply);
                 const Score score =
-                  -search<NodeType::NON_PV>(pos_copy, depth - r, -beta, -beta + 1, ply, false);
+                  -search<THEM, NodeType::NON_PV>(pos_copy, depth - r, -beta, -beta + 1, ply + 1,
+                                                  false);
                 undoNullMove();
                 if (score >= beta)
                 {
@@ -308,6 +657,68 @@ namespace sagittar::search {
                 }
             }
 
+            // ProbCut
+            // A capture that holds beta + margin at reduced depth will very likely hold beta
+            const Score probcut_beta = beta + params::probcut_margin();
+            if (depth >= params::probcut_depth_min() && std::abs(beta) < WIN_SCORE
+                && !(tthit && ttdata.depth >= depth - 3 && ttdata.score < probcut_beta))
+            {
+                const Move pc_ttmove =
+                  (tthit && ttdata.move.isCapture()) ? ttdata.move : NULL_MOVE;
+
+                // The main MovePicker of this node is not built yet, share its buffer
+                MovePicker<US> pc_picker(move_buffers[ply][0].data(), pos, pc_ttmove, history,
+                                         contHistEntries(ply), capt_history, NULL_MOVE, NULL_MOVE,
+                                         NULL_MOVE, MovegenType::CAPTURES);
+
+                while (pc_picker.hasNext())
+                {
+                    const Move move = pc_picker.next();
+
+                    if (!see(pos, move, probcut_beta - static_eval))
+                    {
+                        continue;
+                    }
+
+                    Position pos_copy = pos;
+                    if (!doMove<US>(pos_copy, move, ply))
+                    {
+                        undoMove();
+                        continue;
+                    }
+
+                    nodes++;
+
+                    stack[ply].move  = move;
+                    stack[ply].piece = pos.pieceOn(move.from());
+
+                    // Cheap qsearch first, only verify the moves that survive it
+                    Score score = -quiescencesearch<THEM>(pos_copy, 0, -probcut_beta,
+                                                          -probcut_beta + 1, ply + 1);
+
+                    if (score >= probcut_beta)
+                    {
+                        score = -search<THEM, NodeType::NON_PV>(
+                          pos_copy, depth - params::probcut_reduction(), -probcut_beta,
+                          -probcut_beta + 1, ply + 1, true);
+                    }
+
+                    undoMove();
+
+                    if (should_stop.load(std::memory_order_relaxed))
+                    {
+                        return 0;
+                    }
+
+                    if (score >= probcut_beta)
+                    {
+                        tt.store(pos.key(), ply, depth - params::probcut_reduction() + 1,
+                                 TTFlag::LOWERBOUND, score, move, raw_eval, tt_pv);
+                        return score;
+                    }
+                }
+            }
+
             // Futility Pruning Decision
             // clang-format off
             if (depth <= 7
@@ -333,40 +744,84 @@ namespace sagittar::search {
         u32    legal_moves_count = 0;
         u32    moves_searched    = 0;
 
+        std::array<Move, 64> quiets_tried;
+        std::array<Move, 32> captures_tried;
+        u32                  quiets_tried_count   = 0;
+        u32                  captures_tried_count = 0;
+
         const Move ttmove = is_root_node ? pvmove : tthit ? ttdata.move : Move{};
 
-        std::array<ExtMove, MOVES_MAX> buffer{};
-        MovePicker move_picker(buffer.data(), pos, ttmove, history, ss.killers[0], ss.killers[1],
-                               MovegenType::ALL);
+        // Singular Extension candidate
+        // The TT move is singular if every alternative fails low against a margin below its score
+        // clang-format off
+        const bool try_singular = !is_root_node
+                               && !is_singular_ext
+                               && depth >= params::se_depth_min()
+                               && ttmove != NULL_MOVE
+                               && ttdata.flag != TTFlag::UPPERBOUND
+                               && ttdata.depth >= depth - 3
+                               && std::abs(ttdata.score) < WIN_SCORE;
+        // clang-format on
+
+        MovePicker<US> move_picker(move_buffers[ply][is_singular_ext].data(), pos, ttmove, history,
+                                   contHistEntries(ply), capt_history, ss.killers[0], ss.killers[1],
+                                   counterMove(ply), MovegenType::ALL);
         const auto n_moves = move_picker.size();
 
         while (move_picker.hasNext())
         {
             const Move move = move_picker.next();
 
-            Position pos_copy = pos;
-            if (!doMove(pos_copy, move))
+            if (move == excluded_move)
             {
-                undoMove();
                 continue;
             }
 
+            Depth extension = 0;
+
+            // Singular Extension
+            // Searched before doMove, the verification search runs on this same node
+            if (try_singular && move == ttmove)
+            {
+                const Score singular_beta  = ttdata.score - params::se_margin() * depth;
+                const Depth singular_depth = (depth - 1) / 2;
+
+                stack[ply].excluded = move;
+                const Score score   = search<US, NodeType::NON_PV>(
+                  pos, singular_depth, singular_beta - 1, singular_beta, ply, do_null);
+                stack[ply].excluded = NULL_MOVE;
+
+                if (should_stop.load(std::memory_order_relaxed))
+                {
+                    return 0;
+                }
+
+                if (score < singular_beta)
+                {
+                    extension = 1;
+                }
+                else if (singular_beta >= beta)
+                {
+                    // Multi-Cut: more than one move beats beta
+                    return singular_beta;
+                }
+            }
+
             const Piece     move_piece      = pos.pieceOn(move.from());
             const PieceType move_piece_type = pieceTypeOf(move_piece);
             const bool      move_is_capture = move.isCapture();
 
-            legal_moves_count++;
-
             const bool move_is_quite    = !(move_is_capture || move.isPromotion());
-            const bool move_gives_check = pos_copy.isInCheck();
+            const bool move_gives_check = pos.givesCheck(move);
 
             // Move Loop Pruning
+            // Decided before the move is made. A legal move has already been searched, so
+            // skipping pseudolegal moves here cannot turn the node into a false mate.
             if (moves_searched > 0 && !is_critical_node && move_is_quite && !move_gives_check)
             {
                 // Futility Pruning
                 if (do_futility_pruning)
                 {
-                    undoMove();
                     continue;
                 }
 
@@ -377,43 +832,61 @@ namespace sagittar::search {
                       n_moves * (1 - (params::lmp_treshold_pct - (0.1 * depth)));
                     if (moves_searched >= LMP_MOVE_CUTOFF)
                     {
-                        undoMove();
                         continue;
                     }
                 }
             }
 
+            Position pos_copy = pos;
+            if (!doMove<US>(pos_copy, move, ply))
+            {
+                undoMove();
+                continue;
+            }
+
+            assert(move_gives_check == pos_copy.isInCheck());
+
+            legal_moves_count++;
+
             nodes++;
 
+            ss.move  = move;
+            ss.piece = move_piece;
+
             Score score = -INF;
 
             if (!is_pv_node || moves_searched > 0)
             {
                 const bool can_reduce = (depth >= 3) && (moves_searched >= 4) && (!is_critical_node)
                                      && (!move_gives_check)
-                                     && (move_picker.phase() != MovePickerPhase::KILLERS);
+                                     && (move_picker.phase() != MovePickerPhase::KILLERS)
+                                     && (move_picker.phase() != MovePickerPhase::COUNTER_MOVE);
 
                 if (can_reduce)
                 {
-                    const u8 r =
+                    u8 r =
                       move_is_quite
                         ? params::lmr_r_table_quiet[std::min(moves_searched, 64U)][(int) depth]
                         : params::lmr_r_table_tactical[std::min(moves_searched, 64U)][(int) depth];
 
-                    score = -search<NodeType::NON_PV>(pos_copy, depth - r, -alpha - 1, -alpha,
-                                                      ply + 1, do_null);
+                    // Reduce less in nodes that have been on the PV
+                    r -= (tt_pv && r > 0);
+
+                    score = -search<THEM, NodeType::NON_PV>(pos_copy, depth - r, -alpha - 1,
+                                                            -alpha, ply + 1, do_null);
                 }
 
                 if (!can_reduce || score > alpha)
                 {
-                    score = -search<NodeType::NON_PV>(pos_copy, depth - 1, -alpha - 1, -alpha,
-                                                      ply + 1, do_null);
+                    score = -search<THEM, NodeType::NON_PV>(pos_copy, depth - 1 + extension,
+                                                            -alpha - 1, -alpha, ply + 1, do_null);
                 }
             }
 
             if (is_pv_node && ((moves_searched == 0) || (score > alpha && score < beta)))
             {
-                score = -search<NodeType::PV>(pos_copy, depth - 1, -beta, -alpha, ply + 1, do_null);
+                score = -search<THEM, NodeType::PV>(pos_copy, depth - 1 + extension, -beta,
+                                                    -alpha, ply + 1, do_null);
             }
 
             moves_searched++;
@@ -436,44 +909,114 @@ namespace sagittar::search {
                     ttflag           = TTFlag::EXACT;
                     if (best_score >= beta)
                     {
+                        const i32 bonus = depth * depth;
+
                         if (!move_is_capture)
                         {
                             // Killer Heuristic
                             ss.killers[1] = ss.killers[0];
                             ss.killers[0] = move;
 
+                            // Counter Move Heuristic
+                            if (ply > 0 && stack[ply - 1].piece != Piece::NO_PIECE)
+                            {
+                                const StackEntry& prev = stack[ply - 1];
+                                counter_moves[prev.piece][prev.move.to()] = move;
+                            }
+
                             // History Heuristic
-                            updateHistory(move_piece, move.to(), depth * depth);
+                            // Reward the cutoff move, penalize the quiets tried before it
+                            updateQuietHistories(ply, move_piece, move.to(), bonus);
+                            for (u32 i = 0; i < quiets_tried_count; i++)
+                            {
+                                const Move quiet = quiets_tried[i];
+                                updateQuietHistories(ply, pos.pieceOn(quiet.from()), quiet.to(),
+                                                     -bonus);
+                            }
                         }
+                        else
+                        {
+                            // Capture History
+                            updateCaptureHistory(pos, move, bonus);
+                        }
+
+                        // Captures that failed low before the cutoff move
+                        for (u32 i = 0; i < captures_tried_count; i++)
+                        {
+                            updateCaptureHistory(pos, captures_tried[i], -bonus);
+                        }
+
                         ttflag = TTFlag::LOWERBOUND;
                         break;
                     }
                 }
             }
+
+            if (move_is_quite && quiets_tried_count < quiets_tried.size())
+            {
+                quiets_tried[quiets_tried_count++] = move;
+            }
+            else if (move_is_capture && captures_tried_count < captures_tried.size())
+            {
+                captures_tried[captures_tried_count++] = move;
+            }
         }
 
         if (legal_moves_count == 0)
         {
+            // The excluded move was the only legal one
+            if (is_singular_ext)
+            {
+                return alpha;
+            }
             return is_in_check ? (-MATE_VALUE + ply) : 0;
         }
 
+        // The singular search result is for a subset of moves, do not pollute TT and histories
+        if (is_singular_ext)
+        {
+            return best_score;
+        }
+
         if (!should_stop.load(std::memory_order_relaxed))
         {
-            tt.store(pos.key(), ply, depth, ttflag, best_score, best_move_so_far);
+            // Correction History
+            // Skip when the bound says nothing about the static eval, or when the score
+            // comes from a capture or a mate.
+            // clang-format off
+            if (!is_in_check
+                && (best_move_so_far == NULL_MOVE || !best_move_so_far.isCapture())
+                && std::abs(best_score) < WIN_SCORE
+                && !(ttflag == TTFlag::LOWERBOUND && best_score <= static_eval)
+                && !(ttflag == TTFlag::UPPERBOUND && best_score >= static_eval))
+            {
+                updateCorrectionHistory(pos, depth, best_score - static_eval);
+            }
+            // clang-format on
+
+            tt.store(pos.key(), ply, depth, ttflag, best_score, best_move_so_far, raw_eval, tt_pv);
 
             if constexpr (is_root_node)
             {
-                pvmove = best_move_so_far;
+                // Keep the previous best move when the root fails low
+                if (best_move_so_far != NULL_MOVE)
+                {
+                    pvmove = best_move_so_far;
+                }
             }
         }
 
         return best_score;
     }
 
+    template<Color US>
     Score Searcher::Worker::quiescencesearch(const Position& pos,
+                                             const Depth     depth,
                                              Score           alpha,
                                              Score           beta,
                                              const i32       ply) {
+        constexpr Color THEM = colorFlip(US);
+
         const Score alpha_orig = alpha;
 
         if ((nodes & 2047) == 0)
@@ -489,11 +1032,12 @@ namespace sagittar::search {
 
         if (ply >= MAX_DEPTH - 1)
         {
-            return is_in_check ? 0 : eval::hce::evaluate(pos);
+            return is_in_check ? 0 : evaluate<US>(pos, ply);
         }
 
         TTData     ttdata;
         const bool tthit = tt.probe(&ttdata, pos.key());
+        const bool tt_pv = tthit && ttdata.pv;
 
         // TT cutoff
         if (tthit)
@@ -517,6 +1061,7 @@ namespace sagittar::search {
         }
 
         Score eval;
+        Score raw_eval = EVAL_NONE;
 
         if (is_in_check)
         {
@@ -524,9 +1069,25 @@ namespace sagittar::search {
         }
         else
         {
-            eval = eval::hce::evaluate(pos);
+            bool is_lazy = false;
+            raw_eval     = (tthit && ttdata.eval != EVAL_NONE)
+                           ? ttdata.eval
+                           : evaluateLazy<US>(pos, ply, alpha, beta, &is_lazy);
+            eval         = raw_eval;
+
+            // A lazy eval is only good enough for this window, keep it out of the TT
+            if (is_lazy)
+            {
+                raw_eval = EVAL_NONE;
+            }
+
             if (eval >= beta)
             {
+                if (!tthit)
+                {
+                    tt.store(pos.key(), ply, 0, TTFlag::LOWERBOUND, beta, NULL_MOVE, raw_eval,
+                             false);
+                }
                 return beta;
             }
             if (alpha < eval)
@@ -539,22 +1100,49 @@ namespace sagittar::search {
         Move  best_move_so_far  = NULL_MOVE;
         u32   legal_moves_count = 0;
 
-        const Move        ttmove = tthit ? ttdata.move : NULL_MOVE;
-        const MovegenType movegen_type =
-          is_in_check ? MovegenType::CHECK_EVASIONS : MovegenType::CAPTURES;
+        // Quiet checks are only tried on the first qsearch ply
+        const bool gen_checks = (depth == 0) && params::qs_quiet_checks();
+
+        const Move        ttmove       = tthit ? ttdata.move : NULL_MOVE;
+        const MovegenType movegen_type = is_in_check ? MovegenType::CHECK_EVASIONS
+                                       : gen_checks  ? MovegenType::QUIET_CHECKS
+                                                     : MovegenType::CAPTURES;
 
         StackEntry& ss = stack[ply];
 
-        std::array<ExtMove, MOVES_MAX> buffer{};
-        MovePicker move_picker(buffer.data(), pos, ttmove, history, ss.killers[0], ss.killers[1],
-                               movegen_type);
+        MovePicker<US> move_picker(move_buffers[ply][0].data(), pos, ttmove, history,
+                                   contHistEntries(ply), capt_history, ss.killers[0], ss.killers[1],
+                                   counterMove(ply), movegen_type);
 
         while (move_picker.hasNext())
         {
             const Move move = move_picker.next();
 
+            if (!is_in_check)
+            {
+                // Delta Pruning
+                // Skip captures that can not raise the stand pat score above alpha
+                if (move.isCapture() && !move.isPromotion())
+                {
+                    const Score futility_score = eval
+                                               + SEE_PIECE_VALUES[capturedPieceType(pos, move)]
+                                               + params::qs_delta_margin();
+                    if (futility_score <= alpha)
+                    {
+                        best_score = std::max(best_score, futility_score);
+                        continue;
+                    }
+                }
+
+                // SEE Pruning
+                if (!see(pos, move, 0))
+                {
+                    continue;
+                }
+            }
+
             Position pos_copy = pos;
-            if (!doMove(pos_copy, move))
+            if (!doMove<US>(pos_copy, move, ply))
             {
                 undoMove();
                 continue;
@@ -563,7 +1151,11 @@ namespace sagittar::search {
             legal_moves_count++;
             nodes++;
 
-            const Score score = -quiescencesearch(pos_copy, -beta, -alpha, ply + 1);
+            ss.move  = move;
+            ss.piece = pos.pieceOn(move.from());
+
+            const Score score =
+              -quiescencesearch<THEM>(pos_copy, depth - 1, -beta, -alpha, ply + 1);
 
             undoMove();
 
@@ -580,7 +1172,8 @@ namespace sagittar::search {
                 best_move_so_far = move;
                 if (score >= beta)
                 {
-                    tt.store(pos.key(), ply, 0, TTFlag::LOWERBOUND, beta, best_move_so_far);
+                    tt.store(pos.key(), ply, 0, TTFlag::LOWERBOUND, beta, best_move_so_far,
+                             raw_eval, tt_pv);
                     return beta;
                 }
             }
@@ -596,7 +1189,7 @@ namespace sagittar::search {
             const TTFlag flag = (best_score <= alpha_orig) ? TTFlag::UPPERBOUND
                               : (best_score >= beta)       ? TTFlag::LOWERBOUND
                                                            : TTFlag::EXACT;
-            tt.store(pos.key(), ply, 0, flag, best_score, best_move_so_far);
+            tt.store(pos.key(), ply, 0, flag, best_score, best_move_so_far, raw_eval, tt_pv);
         }
 
         return best_score;
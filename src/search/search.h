@@ -1,9 +1,13 @@
 #pragma once
 
 #include "commons/pch.h"
+#include "core/keyhistory.h"
 #include "core/move.h"
 #include "core/position.h"
 #include "core/types.h"
+#include "eval/evalcache.h"
+#include "eval/hce/eval.h"
+#include "eval/nnue/nnue.h"
 #include "search/history.h"
 #include "search/tt.h"
 #include "search/types.h"
@@ -14,10 +18,14 @@ namespace sagittar::search {
     constexpr Score MATE_VALUE = 14000;
     constexpr Score MATE_SCORE = 13000;
     constexpr Score WIN_SCORE  = 12000;
+    constexpr Score EVAL_NONE  = -INF - 1;
     constexpr Depth MAX_DEPTH  = 64;
 
     constexpr std::size_t DEFAULT_TT_SIZE_MB = 16;
 
+    static_assert(MAX_DEPTH < KeyHistory::SEARCH_CAPACITY);
+    static_assert(eval::nnue::MAX_EVAL < WIN_SCORE);
+
     class Searcher {
        public:
         Searcher();
@@ -32,23 +40,44 @@ namespace sagittar::search {
 
         void setTranspositionTableSize(const std::size_t);
         void setThreadCount(const std::size_t);
+        void setUseNNUE(const bool);
+        void setEvalCacheSize(const std::size_t);
+        void clearEvalCaches();
 
         [[nodiscard]] SearchResult startSearch(const Position&                          pos,
-                                               std::span<u64>                           key_history,
+                                               std::span<const u64>                     key_history,
                                                SearchInfo                               info,
                                                std::function<void(const SearchResult&)> onProgress,
                                                std::function<void(const SearchResult&)> onComplete);
 
         [[nodiscard]] SearchResult
-        startSearch(const Position& pos, std::span<u64> key_history, SearchInfo info);
+        startSearch(const Position& pos, std::span<const u64> key_history, SearchInfo info);
 
         void stopSearch();
 
        private:
+        // Outlive the workers, one per thread. Each is (re)allocated by the thread using it.
+        struct ThreadCaches {
+            eval::EvalCache   eval;
+            eval::hce::Caches hce;
+        };
+
+        // The tables' answer at the root, the same for every iteration of a search
+        struct RootTablebase {
+            bool  solved{false};
+            Move  move{};
+            Score score{0};
+        };
+
         class Worker {
            public:
             Worker() = delete;
-            Worker(std::span<u64>, const SearchInfo&, TranspositionTable&);
+            Worker(std::span<const u64>,
+                   const SearchInfo&,
+                   TranspositionTable&,
+                   ThreadCaches&,
+                   const RootTablebase&,
+                   const bool use_nnue);
             Worker(const Worker&)            = delete;
             Worker(Worker&&)                 = delete;
             Worker& operator=(const Worker&) = delete;
@@ -70,18 +99,39 @@ namespace sagittar::search {
 
             struct StackEntry {
                 std::array<Move, 2> killers{};
+                Move                move{};
+                Piece               piece{Piece::NO_PIECE};
+                Move                excluded{};  // Skipped by singular extension searches
             };
 
             void checkTimeUp();
 
-            bool doMove(Position&, const Move&);
-            void doNullMove(Position&);
+            template<Color US>
+            bool doMove(Position&, const Move&, const i32 ply);
+            void doNullMove(Position&, const i32 ply);
             void undoMove();
             void undoNullMove();
 
-            void updateHistory(const Piece, const Square, const i32);
+            template<Color US>
+            [[nodiscard]] Score evaluate(const Position&, const i32 ply);
+
+            // Stops at the cheap eval terms when they are far enough outside [alpha, beta]
+            template<Color US>
+            [[nodiscard]] Score evaluateLazy(
+              const Position&, const i32 ply, const Score alpha, const Score beta, bool* is_lazy);
+
+            void updateHistory(PieceToHistory&, const Piece, const Square, const i32);
+            void updateQuietHistories(const i32 ply, const Piece, const Square, const i32);
+            void updateCaptureHistory(const Position&, const Move&, const i32);
 
-            template<NodeType nodeType>
+            void updateCorrectionHistory(const Position&, const Depth, const Score);
+
+            [[nodiscard]] Score correctStaticEval(const Position&, const Score) const;
+
+            [[nodiscard]] ContHistEntries contHistEntries(const i32 ply) const;
+            [[nodiscard]] Move            counterMove(const i32 ply) const;
+
+            template<Color US, NodeType nodeType>
             Score search(const Position& pos,
                          Depth           depth,
                          Score           alpha,
@@ -89,23 +139,47 @@ namespace sagittar::search {
                          const i32       ply,
                          const bool      do_null);
 
-            Score quiescencesearch(const Position& pos, Score alpha, Score beta, const i32 ply);
+            template<Color US>
+            Score quiescencesearch(const Position& pos,
+                                   const Depth     depth,
+                                   Score           alpha,
+                                   Score           beta,
+                                   const i32       ply);
 
             std::atomic_bool    should_stop{false};
-            std::vector<u64>    key_history{};
+            KeyHistory          key_history;
             SearchInfo          info{};
             TranspositionTable& tt;
+            ThreadCaches&       caches;
+            const RootTablebase root_tablebase;
+            const bool          use_nnue;
 
             size_t nodes{0};
 
             Move                              pvmove{};
-            PieceToHistory                    history{};  // [piece][to]
+            PieceToHistory                    history{};            // [piece][to]
+            ContinuationHistory               cont_history{};       // [piece][to][piece][to]
+            CaptureHistory                    capt_history{};       // [piece][to][captured]
+            CounterMoveTable                  counter_moves{};      // [piece][to]
+            CorrectionHistory                 pawn_corrhist{};      // [stm][pawn key]
+            std::array<CorrectionHistory, 2>  non_pawn_corrhist{};  // [color][stm][non-pawn key]
             std::array<StackEntry, MAX_DEPTH> stack{};
+
+            // MovePicker storage, one per ply and a second one for singular extension searches
+            // that run on the same ply as the node they verify.
+            std::array<std::array<std::array<ExtMove, MOVES_MAX>, 2>, MAX_DEPTH> move_buffers;
+
+            // NNUE accumulators of the positions on the current line, indexed by ply
+            std::array<eval::nnue::Accumulator, MAX_DEPTH> accumulators;
         };
 
         TranspositionTable                   tt{DEFAULT_TT_SIZE_MB};
         size_t                               n_threads{1};
+        bool                                 use_nnue{false};
+        std::size_t                          eval_cache_size{eval::DEFAULT_EVAL_CACHE_SIZE_MB};
         std::vector<std::unique_ptr<Worker>> workers;
+
+        std::vector<std::unique_ptr<ThreadCaches>> caches;
     };
 
 }
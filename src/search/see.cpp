@@ -0,0 +1,120 @@
+#include "see.h"
+#include "core/movegen.h"
+
+namespace sagittar::search {
+
+    static BitBoard attackersTo(const Position& pos, const Square sq, const BitBoard occupancy) {
+        const BitBoard bishops = pos.pieces(PieceType::BISHOP, PieceType::QUEEN);
+        const BitBoard rooks   = pos.pieces(PieceType::ROOK, PieceType::QUEEN);
+        // clang-format off
+        return attacks<PieceType::PAWN>(sq, pos.pieces(Color::WHITE, PieceType::PAWN), Color::BLACK)
+             | attacks<PieceType::PAWN>(sq, pos.pieces(Color::BLACK, PieceType::PAWN), Color::WHITE)
+             | attacks<PieceType::KNIGHT>(sq, pos.pieces(PieceType::KNIGHT))
+             | (attacks<PieceType::BISHOP>(sq, occupancy) & bishops)
+             | (attacks<PieceType::ROOK>(sq, occupancy) & rooks)
+             | attacks<PieceType::KING>(sq, pos.pieces(PieceType::KING));
+        // clang-format on
+    }
+
+    bool see(const Position& pos, const Move& move, const Score threshold) {
+        const MoveFlag flag = move.flag();
+
+        if (flag == MoveFlag::MOVE_CASTLE_KING_SIDE || flag == MoveFlag::MOVE_CASTLE_QUEEN_SIDE)
+        {
+            return threshold <= 0;
+        }
+
+        const Square from = move.from();
+        const Square to   = move.to();
+
+        PieceType attacker = pieceTypeOf(pos.pieceOn(from));
+        PieceType victim   = PieceType::PIECE_TYPE_INVALID;
+        if (move.isCapture())
+        {
+            victim = (flag == MoveFlag::MOVE_CAPTURE_EP) ? PieceType::PAWN
+                                                         : pieceTypeOf(pos.pieceOn(to));
+        }
+
+        // Gain of the move itself, before any recapture
+        Score swap = (victim == PieceType::PIECE_TYPE_INVALID) ? 0 : SEE_PIECE_VALUES[victim];
+        if (move.isPromotion())
+        {
+            attacker = static_cast<PieceType>(PieceType::KNIGHT + (flag & 0x3));
+            swap += SEE_PIECE_VALUES[attacker] - SEE_PIECE_VALUES[PieceType::PAWN];
+        }
+
+        swap -= threshold;
+        if (swap < 0)
+        {
+            return false;
+        }
+
+        // Even losing the moved piece for nothing still passes the threshold
+        swap = SEE_PIECE_VALUES[attacker] - swap;
+        if (swap <= 0)
+        {
+            return true;
+        }
+
+        BitBoard occupancy = pos.occupied() ^ BB(from) ^ BB(to);
+        if (flag == MoveFlag::MOVE_CAPTURE_EP)
+        {
+            occupancy ^= BB(pos.stm() == Color::WHITE ? to - 8 : to + 8);
+        }
+
+        const BitBoard bishops = pos.pieces(PieceType::BISHOP, PieceType::QUEEN);
+        const BitBoard rooks   = pos.pieces(PieceType::ROOK, PieceType::QUEEN);
+
+        BitBoard attackers = attackersTo(pos, to, occupancy);
+        Color    stm       = pos.stm();
+        bool     result    = true;
+
+        while (true)
+        {
+            stm = colorFlip(stm);
+            attackers &= occupancy;
+
+            const BitBoard stm_attackers = attackers & pos.pieces(stm);
+            if (stm_attackers.is_empty())
+            {
+                break;
+            }
+
+            result = !result;
+
+            // Recapture with the least valuable attacker
+            PieceType pt = PieceType::PAWN;
+            while ((stm_attackers & pos.pieces(pt)).is_empty())
+            {
+                pt = static_cast<PieceType>(pt + 1);
+            }
+
+            if (pt == PieceType::KING)
+            {
+                // The king can only recapture if the opponent has no attackers left
+                return ((attackers & pos.pieces(colorFlip(stm))).is_empty()) ? result : !result;
+            }
+
+            swap = SEE_PIECE_VALUES[pt] - swap;
+            if (swap < static_cast<Score>(result))
+            {
+                break;
+            }
+
+            occupancy ^= BB((stm_attackers & pos.pieces(pt)).lsb());
+
+            // Add the x-ray attackers uncovered by the recapture
+            if (pt == PieceType::PAWN || pt == PieceType::BISHOP || pt == PieceType::QUEEN)
+            {
+                attackers |= attacks<PieceType::BISHOP>(to, occupancy) & bishops;
+            }
+            if (pt == PieceType::ROOK || pt == PieceType::QUEEN)
+            {
+                attackers |= attacks<PieceType::ROOK>(to, occupancy) & rooks;
+            }
+        }
+
+        return result;
+    }
+
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "commons/pch.h"
+#include "core/move.h"
+#include "core/position.h"
+#include "core/types.h"
+
+namespace sagittar::search {
+
+    // Piece values used by the static exchange evaluation, [piece type]
+    static constexpr std::array<Score, 6> SEE_PIECE_VALUES = {100, 300, 300, 500, 900, 0};
+
+    // Static Exchange Evaluation
+    // Returns true if the exchange sequence started by move on its target square gains at least
+    // threshold for the side to move. Pins are ignored.
+    [[nodiscard]] bool see(const Position& pos, const Move& move, const Score threshold);
+
+}
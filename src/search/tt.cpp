@@ -35,7 +35,9 @@ namespace sagittar::search {
                                    const Depth  depth,
                                    const TTFlag flag,
                                    Score        value,
-                                   const Move&  move) {
+                                   const Move&  move,
+                                   const Score  eval,
+                                   const bool   pv) {
         const u64     index     = getIndex(hash);
         const TTEntry currentry = entries.at(index);
 
@@ -67,9 +69,10 @@ namespace sagittar::search {
         TTEntry newentry;
         newentry.key         = hash;
         newentry.score       = static_cast<i16>(value);
+        newentry.eval        = static_cast<i16>(eval);
         newentry.move_id     = move_to_replace.id();
         newentry.depth       = static_cast<i8>(depth);
-        newentry.age_flag_pv = TTEntry::foldAgeFlagPV(currentage, flag, false);
+        newentry.age_flag_pv = TTEntry::foldAgeFlagPV(currentage, flag, pv);
 
         entries.at(index) = newentry;
     }
@@ -83,7 +86,9 @@ namespace sagittar::search {
             ttdata->depth = static_cast<Depth>(currentry.depth);
             ttdata->flag  = currentry.flag();
             ttdata->score = static_cast<Score>(currentry.score);
+            ttdata->eval  = static_cast<Score>(currentry.eval);
             ttdata->move  = currentry.move();
+            ttdata->pv    = currentry.pv();
             return true;
         }
 
@@ -18,13 +18,17 @@ namespace sagittar::search {
         Depth  depth;
         TTFlag flag;
         Score  score;
+        Score  eval;
         Move   move;
+        bool   pv;
 
         TTData() :
             depth(0),
             flag(TTFlag::NONE),
             score(0),
-            move(Move()) {}
+            eval(0),
+            move(Move()),
+            pv(false) {}
     };
 
     class TranspositionTable {
@@ -34,6 +38,7 @@ namespace sagittar::search {
 
             u64 key;
             i16 score;
+            i16 eval;
             u16 move_id;
             i8  depth;
             u8  age_flag_pv;
@@ -41,6 +46,7 @@ namespace sagittar::search {
             TTEntry() :
                 key(0ULL),
                 score(0),
+                eval(0),
                 move_id(Move().id()),
                 depth(0),
                 age_flag_pv(0) {}
@@ -58,6 +64,8 @@ namespace sagittar::search {
             }
         };
 
+        static_assert(sizeof(TTEntry) == 16);
+
         static constexpr u8 AGE_CYCLE_LEN = 1 << TTEntry::AGE_BITS;
 
         std::vector<TTEntry> entries;
@@ -78,7 +86,9 @@ namespace sagittar::search {
                                  const Depth  depth,
                                  const TTFlag flag,
                                  Score        value,
-                                 const Move&  move);
+                                 const Move&  move,
+                                 const Score  eval,
+                                 const bool   pv);
         [[nodiscard]] bool probe(TTData* entry, const u64 hash) const;
         u32                hashfull() const;
     };
@@ -29,8 +29,15 @@ namespace sagittar::search {
             stoptime(0ULL) {}
     };
 
+    enum class ScoreBound : u8 {
+        EXACT,
+        LOWERBOUND,
+        UPPERBOUND
+    };
+
     struct SearchResult {
         Score             score;
+        ScoreBound        bound{ScoreBound::EXACT};
         bool              is_mate;
         i8                mate_in;
         Depth             depth;
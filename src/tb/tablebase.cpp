@@ -0,0 +1,407 @@
+#include "tablebase.h"
+#include <cstring>
+#include <unordered_map>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace sagittar::tb {
+
+    namespace {
+
+        constexpr std::string_view PIECE_CHARS = "PNBRQK";
+
+        constexpr std::array<Square, 10> TRIANGLE = {
+          Square::A1, Square::B1, Square::C1, Square::D1, Square::B2,
+          Square::C2, Square::D2, Square::C3, Square::D3, Square::D4,
+        };
+
+        constexpr std::array<u8, 64> TRIANGLE_INDEX = []() {
+            std::array<u8, 64> index{};
+            for (std::size_t i = 0; i < TRIANGLE.size(); i++)
+            {
+                index[TRIANGLE[i]] = static_cast<u8>(i);
+            }
+            return index;
+        }();
+
+        constexpr Square transpose(const Square sq) {
+            return rf2sq(static_cast<u8>(sq2file(sq)), static_cast<u8>(sq2rank(sq)));
+        }
+
+        PieceType pieceTypeOfChar(const char c) {
+            const std::size_t pt = PIECE_CHARS.find(c);
+            return (pt == std::string_view::npos) ? PieceType::PIECE_TYPE_INVALID
+                                                  : static_cast<PieceType>(pt);
+        }
+
+        void unmap(void* data, const std::size_t length) {
+#if defined(_WIN32)
+            (void) length;
+            UnmapViewOfFile(data);
+#else
+            munmap(data, length);
+#endif
+        }
+
+        // The whole file, read only
+        void* map(const std::filesystem::path& path, std::size_t* length) {
+#if defined(_WIN32)
+            HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                return nullptr;
+            }
+
+            LARGE_INTEGER size;
+            HANDLE        mapping = nullptr;
+            if (GetFileSizeEx(file, &size) && (size.QuadPart > 0))
+            {
+                mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            }
+            CloseHandle(file);
+            if (mapping == nullptr)
+            {
+                return nullptr;
+            }
+
+            // The view keeps the mapping alive
+            void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+
+            *length = static_cast<std::size_t>(size.QuadPart);
+            return data;
+#else
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                return nullptr;
+            }
+
+            struct stat st;
+            void*       data = MAP_FAILED;
+            if ((fstat(fd, &st) == 0) && (st.st_size > 0))
+            {
+                *length = static_cast<std::size_t>(st.st_size);
+                data    = mmap(nullptr, *length, PROT_READ, MAP_SHARED, fd, 0);
+            }
+            close(fd);
+
+            return (data == MAP_FAILED) ? nullptr : data;
+#endif
+        }
+
+        // Of any placement of the pieces, with the colors swapped or not
+        u64 materialKey(const Material& material, const bool swapped) {
+            std::array<std::string, 2> pieces;
+            for (int i = 0; i < material.n; i++)
+            {
+                const Color c  = swapped ? colorFlip(material.colors[i]) : material.colors[i];
+                const char  pc = PIECE_CHARS[material.types[i]];
+                pieces[c] += (c == Color::WHITE) ? pc : static_cast<char>(std::tolower(pc));
+            }
+
+            const auto rank = [](const std::string& s) {
+                return s + std::to_string(8 - s.size());
+            };
+
+            Position pos;
+            pos.setFen("8/" + rank(pieces[Color::BLACK]) + "/8/8/8/8/" + rank(pieces[Color::WHITE])
+                       + "/8 w - - 0 1");
+            return pos.material_key();
+        }
+
+        struct Entry {
+            const Table* table;
+            bool         swapped;  // The position's black pieces are the table's white ones
+        };
+
+        std::vector<std::unique_ptr<Table>> tables;
+        std::unordered_map<u64, Entry>      entries;  // By material key
+        int                                 max_pieces = 0;
+
+    }
+
+    bool Material::parse(const std::string& code, Material* material) {
+        const std::size_t split = code.find('K', 1);
+        if (code.empty() || (code[0] != 'K') || (split == std::string::npos)
+            || (code.size() > MAX_PIECES))
+        {
+            return false;
+        }
+
+        std::array<std::vector<PieceType>, 2> sides;
+        for (std::size_t i = 1; i < code.size(); i++)
+        {
+            if (i == split)
+            {
+                continue;
+            }
+
+            const PieceType pt = pieceTypeOfChar(code[i]);
+            if ((pt == PieceType::PAWN) || (pt == PieceType::KING)
+                || (pt == PieceType::PIECE_TYPE_INVALID))
+            {
+                return false;
+            }
+            sides[(i < split) ? Color::WHITE : Color::BLACK].push_back(pt);
+        }
+
+        // The most valuable pieces first, and the stronger side as white
+        for (auto& side : sides)
+        {
+            std::sort(side.begin(), side.end(), std::greater<>());
+        }
+        if (sides[Color::WHITE] < sides[Color::BLACK])
+        {
+            std::swap(sides[Color::WHITE], sides[Color::BLACK]);
+        }
+
+        Material m;
+        m.types[m.n]    = PieceType::KING;
+        m.colors[m.n++] = Color::WHITE;
+        m.types[m.n]    = PieceType::KING;
+        m.colors[m.n++] = Color::BLACK;
+        for (const Color c : {Color::WHITE, Color::BLACK})
+        {
+            for (const PieceType pt : sides[c])
+            {
+                m.types[m.n]    = pt;
+                m.colors[m.n++] = c;
+            }
+        }
+
+        *material = m;
+        return true;
+    }
+
+    std::string Material::code() const {
+        std::string code = "K";
+        for (const Color c : {Color::WHITE, Color::BLACK})
+        {
+            for (int i = 2; i < n; i++)
+            {
+                if (colors[i] == c)
+                {
+                    code += PIECE_CHARS[types[i]];
+                }
+            }
+            if (c == Color::WHITE)
+            {
+                code += 'K';
+            }
+        }
+        return code;
+    }
+
+    u64 Material::size() const {
+        u64 size = TRIANGLE.size();
+        for (int i = 1; i < n; i++)
+        {
+            size *= 64;
+        }
+        return size;
+    }
+
+    u64 encode(const Material& material, const Squares& squares) {
+        const Square wksq = squares[0];
+        const u8     flip = ((sq2file(wksq) > File::FILE_D) ? 7 : 0)
+                      ^ ((sq2rank(wksq) > Rank::RANK_4) ? 56 : 0);
+
+        // Off the diagonal the first piece off it decides, so each position has a single index
+        bool transposed = false;
+        for (int i = 0; i < material.n; i++)
+        {
+            const Square sq   = static_cast<Square>(squares[i] ^ flip);
+            const int    rank = sq2rank(sq);
+            const int    file = sq2file(sq);
+            if (rank != file)
+            {
+                transposed = rank > file;
+                break;
+            }
+        }
+
+        u64 index = 0;
+        for (int i = 0; i < material.n; i++)
+        {
+            Square sq = static_cast<Square>(squares[i] ^ flip);
+            if (transposed)
+            {
+                sq = transpose(sq);
+            }
+            index = (i == 0) ? TRIANGLE_INDEX[sq] : (index * 64) + sq;
+        }
+        return index;
+    }
+
+    void decode(const Material& material, u64 index, Squares* squares) {
+        for (int i = material.n - 1; i > 0; i--)
+        {
+            (*squares)[i] = static_cast<Square>(index & 63);
+            index >>= 6;
+        }
+        (*squares)[0] = TRIANGLE[index];
+    }
+
+    u8 toValue(const ProbeResult& result) {
+        switch (result.wdl)
+        {
+            case WDL::WIN :
+                return static_cast<u8>((result.plies + 1) / 2);
+            case WDL::LOSS :
+                return static_cast<u8>(VALUE_LOSS + (result.plies / 2));
+            default :
+                return VALUE_DRAW;
+        }
+    }
+
+    ProbeResult fromValue(const u8 value) {
+        if (value == VALUE_DRAW)
+        {
+            return ProbeResult{};
+        }
+        if (value < VALUE_LOSS)
+        {
+            return ProbeResult{WDL::WIN, (2 * value) - 1};
+        }
+        return ProbeResult{WDL::LOSS, 2 * (value - VALUE_LOSS)};
+    }
+
+    Table::~Table() {
+        if (m_mapping != nullptr)
+        {
+            unmap(m_mapping, m_length);
+        }
+    }
+
+    bool Table::open(const std::filesystem::path& path) {
+        assert(m_mapping == nullptr);
+
+        m_mapping = map(path, &m_length);
+        if (m_mapping == nullptr)
+        {
+            return false;
+        }
+
+        const auto* bytes = static_cast<const u8*>(m_mapping);
+
+        TableHeader header{};
+        if (m_length >= sizeof(TableHeader))
+        {
+            std::memcpy(&header, bytes, sizeof(TableHeader));
+        }
+
+        const std::string code(header.code, strnlen(header.code, sizeof(header.code)));
+
+        if ((header.magic != TB_MAGIC) || (header.version != TB_VERSION)
+            || !Material::parse(code, &m_material) || (m_material.code() != code)
+            || (header.size != m_material.size())
+            || (m_length != sizeof(TableHeader) + (2 * header.size)))
+        {
+            unmap(m_mapping, m_length);
+            m_mapping = nullptr;
+            return false;
+        }
+
+        m_values = bytes + sizeof(TableHeader);
+        return true;
+    }
+
+    std::filesystem::path tablePath(const std::filesystem::path& dir, const Material& material) {
+        return dir / (material.code() + ".sgtb");
+    }
+
+    std::size_t load(const std::filesystem::path& dir) {
+        entries.clear();
+        tables.clear();
+        max_pieces = 0;
+
+        std::error_code ec;
+        for (const auto& file : std::filesystem::directory_iterator(dir, ec))
+        {
+            if (file.path().extension() != ".sgtb")
+            {
+                continue;
+            }
+
+            auto table = std::make_unique<Table>();
+            if (!table->open(file.path()))
+            {
+                continue;
+            }
+
+            const Material& material = table->material();
+            for (const bool swapped : {false, true})
+            {
+                entries.try_emplace(materialKey(material, swapped), Entry{table.get(), swapped});
+            }
+            max_pieces = std::max(max_pieces, material.n);
+
+            tables.push_back(std::move(table));
+        }
+
+        return tables.size();
+    }
+
+    int maxPieces() { return max_pieces; }
+
+    bool probe(const Position& pos, ProbeResult* result) {
+        const int n = pos.occupied().count();
+        if ((n > max_pieces) || (pos.caRights() != 0))
+        {
+            return false;
+        }
+
+        if (n == 2)
+        {
+            *result = ProbeResult{};
+            return true;
+        }
+
+        const auto it = entries.find(pos.material_key());
+        if (it == entries.end())
+        {
+            return false;
+        }
+
+        const auto& [table, swapped] = it->second;
+        const Material& material     = table->material();
+        const u8        flip         = swapped ? 56 : 0;
+
+        // Pieces of a kind in any order, each order has its index
+        Squares  squares{};
+        BitBoard taken{};
+        for (int i = 0; i < material.n; i++)
+        {
+            const Color  c  = swapped ? colorFlip(material.colors[i]) : material.colors[i];
+            const BitBoard pieces = pos.pieces(c, material.types[i]) & ~taken;
+            const Square   sq     = static_cast<Square>(pieces.lsb());
+            taken |= BB(sq);
+            squares[i] = static_cast<Square>(sq ^ flip);
+        }
+
+        const Color       stm   = swapped ? colorFlip(pos.stm()) : pos.stm();
+        const ProbeResult found = fromValue(table->value(stm, encode(material, squares)));
+
+        // The mate may not come before the fifty move rule, unless a capture resets the clock
+        if ((found.wdl != WDL::DRAW) && (pos.halfmoves() + found.plies > 100))
+        {
+            return false;
+        }
+
+        *result = found;
+        return true;
+    }
+
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <filesystem>
+#include "commons/pch.h"
+#include "core/position.h"
+#include "core/types.h"
+
+namespace sagittar::tb {
+
+    // Pawnless material only, kings included
+    constexpr int MAX_PIECES = 5;
+
+    enum class WDL : i8 {
+        LOSS = -1,
+        DRAW = 0,
+        WIN  = 1
+    };
+
+    // For the side to move. Plies to mate, unless a draw.
+    struct ProbeResult {
+        WDL wdl{WDL::DRAW};
+        i32 plies{0};
+    };
+
+    // Pieces of a table: the two kings, then the other pieces of each side from the most valuable.
+    // The stronger side plays white in the table, the other material is a color swap of it.
+    struct Material {
+        int                               n{0};
+        std::array<PieceType, MAX_PIECES> types{};
+        std::array<Color, MAX_PIECES>     colors{};
+
+        // From a code like "KQKR", in either order. False for pawns or too many pieces.
+        static bool parse(const std::string& code, Material*);
+
+        std::string code() const;
+
+        // Positions with each side to move
+        u64 size() const;
+    };
+
+    using Squares = std::array<Square, MAX_PIECES>;
+
+    // By material order. Symmetries of the board are folded into the white king's square, kept in
+    // the a1-d1-d4 triangle: 10 x 64^(n - 1) positions instead of 64^n. Indices of positions with
+    // a symmetric twin in the table are never encoded.
+    u64  encode(const Material&, const Squares&);
+    void decode(const Material&, u64 index, Squares*);
+
+    // One byte per position: 0 is a draw, 1 to 127 a win in that many moves, and 128 + n a loss
+    // in n moves
+    constexpr u8  VALUE_DRAW = 0;
+    constexpr u8  VALUE_LOSS = 128;
+    constexpr i32 MAX_PLIES  = 253;
+
+    u8          toValue(const ProbeResult&);
+    ProbeResult fromValue(const u8);
+
+    // File header, followed by the values with white and then black to move
+    constexpr u32 TB_MAGIC   = 0x42544753;  // "SGTB"
+    constexpr u32 TB_VERSION = 1;
+
+    struct TableHeader {
+        u32  magic;
+        u32  version;
+        char code[16];
+        u64  size;
+    };
+
+    // A table file mapped into memory and read in place
+    class Table {
+       public:
+        Table() = default;
+        Table(const Table&)            = delete;
+        Table& operator=(const Table&) = delete;
+        ~Table();
+
+        [[nodiscard]] bool open(const std::filesystem::path&);
+
+        const Material& material() const { return m_material; }
+
+        u8 value(const Color stm, const u64 index) const {
+            return m_values[(stm * m_material.size()) + index];
+        }
+
+       private:
+        Material    m_material;
+        const u8*   m_values{nullptr};
+        void*       m_mapping{nullptr};
+        std::size_t m_length{0};
+    };
+
+    std::filesystem::path tablePath(const std::filesystem::path& dir, const Material&);
+
+    // Maps every table in dir, replacing the tables loaded before. Must not run during a search.
+    std::size_t load(const std::filesystem::path& dir);
+
+    // Most pieces of a loaded table, 0 when none is loaded
+    int maxPieces();
+
+    // Lock free, the tables are read only once loaded. False when no table has the material, or
+    // when the halfmove clock may run out before the mate: the tables ignore the fifty move rule.
+    bool probe(const Position&, ProbeResult*);
+
+}
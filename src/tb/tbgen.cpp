@@ -0,0 +1,636 @@
+#include "tbgen.h"
+#include <atomic>
+#include <fstream>
+#include <thread>
+#include "core/bitboard.h"
+#include "core/movegen.h"
+#include "core/types.h"
+#include "tb/tablebase.h"
+
+namespace sagittar::tb {
+
+    namespace {
+
+        // Positions not resolved yet, draws once generation ends
+        constexpr u8 VALUE_UNKNOWN = 255;
+
+        constexpr std::string_view PIECE_CHARS = "PNBRQK";
+
+        constexpr BitBoard ALL_SQUARES{~0ULL};
+
+        BitBoard attacksOf(const PieceType pt, const Square sq, const BitBoard occupied) {
+            switch (pt)
+            {
+                case PieceType::KNIGHT :
+                    return attacks<PieceType::KNIGHT>(sq, ALL_SQUARES);
+                case PieceType::BISHOP :
+                    return attacks<PieceType::BISHOP>(sq, occupied);
+                case PieceType::ROOK :
+                    return attacks<PieceType::ROOK>(sq, occupied);
+                case PieceType::QUEEN :
+                    return attacks<PieceType::QUEEN>(sq, occupied);
+                default :
+                    return attacks<PieceType::KING>(sq, ALL_SQUARES);
+            }
+        }
+
+        // Runs fn(begin, end) over [0, size) on every core. Chunks are whole words of a bitset, so
+        // no two threads write the same word.
+        template<typename Fn>
+        void parallelFor(const u64 size, Fn&& fn) {
+            constexpr u64 CHUNK = 1ULL << 14;
+
+            const unsigned int       n_threads = std::max(1U, std::thread::hardware_concurrency());
+            std::atomic<u64>         next{0};
+            std::vector<std::thread> threads;
+            for (unsigned int t = 0; t < n_threads; t++)
+            {
+                threads.emplace_back([&]() {
+                    for (u64 begin = next.fetch_add(CHUNK); begin < size;
+                         begin     = next.fetch_add(CHUNK))
+                    {
+                        fn(begin, std::min(begin + CHUNK, size));
+                    }
+                });
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+        }
+
+        // The table a capture leads to, with the pieces left
+        struct Capture {
+            std::unique_ptr<Table>      table;    // Null when only the kings are left
+            bool                        swapped;  // The table's white pieces are our black ones
+            std::array<int, MAX_PIECES> slots;    // Our piece for each piece of the table
+        };
+
+        class Generator {
+           public:
+            Generator(const Material& material, std::array<Capture, MAX_PIECES>& captures) :
+                material(material),
+                size(material.size()),
+                captures(captures) {
+                for (const Color c : {Color::WHITE, Color::BLACK})
+                {
+                    values[c].assign(size, VALUE_UNKNOWN);
+                    events[c].assign(size, 0);
+                    candidates[c].assign((size + 63) / 64, 0);
+                    changed[c].assign((size + 63) / 64, 0);
+                }
+            }
+
+            // False when a mate is too long for the table format
+            bool run() {
+                for (const Color c : {Color::WHITE, Color::BLACK})
+                {
+                    parallelFor(size, [&](const u64 begin, const u64 end) {
+                        for (u64 i = begin; i < end; i++)
+                        {
+                            initialize(c, i);
+                        }
+                    });
+                }
+
+                for (i32 pass = 1;; pass++)
+                {
+                    if (pass > MAX_PLIES)
+                    {
+                        return false;
+                    }
+
+                    // Positions changed in the last pass make their predecessors worth a look
+                    for (const Color c : {Color::WHITE, Color::BLACK})
+                    {
+                        parallelFor(changed[c].size(), [&](const u64 begin, const u64 end) {
+                            for (u64 w = begin; w < end; w++)
+                            {
+                                for (u64 bits = changed[c][w]; bits; bits &= bits - 1)
+                                {
+                                    markPredecessors(c, (w * 64) + std::countr_zero(bits));
+                                }
+                                changed[c][w] = 0;
+                            }
+                        });
+                    }
+
+                    std::atomic<u64> resolved{0};
+                    for (const Color c : {Color::WHITE, Color::BLACK})
+                    {
+                        parallelFor(size, [&](const u64 begin, const u64 end) {
+                            resolved.fetch_add(resolve(c, pass, begin, end),
+                                               std::memory_order_relaxed);
+                        });
+                    }
+
+                    // Captures into a longer mate than any found here still resolve positions later
+                    if ((resolved == 0) && (pass >= last_event))
+                    {
+                        break;
+                    }
+                }
+
+                for (const Color c : {Color::WHITE, Color::BLACK})
+                {
+                    std::replace(values[c].begin(), values[c].end(), VALUE_UNKNOWN, VALUE_DRAW);
+                }
+                return true;
+            }
+
+            bool write(const std::filesystem::path& path) const {
+                TableHeader header{};
+                header.magic   = TB_MAGIC;
+                header.version = TB_VERSION;
+                header.size    = size;
+                const std::string code = material.code();
+                std::copy(code.begin(), code.end(), header.code);
+
+                // Complete files only, the engine may be loading from the same directory
+                std::filesystem::path tmp_path = path;
+                tmp_path += ".tmp";
+                {
+                    std::ofstream file(tmp_path, std::ios::binary);
+                    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                    for (const Color c : {Color::WHITE, Color::BLACK})
+                    {
+                        file.write(reinterpret_cast<const char*>(values[c].data()),
+                                   static_cast<std::streamsize>(size));
+                    }
+                    if (!file)
+                    {
+                        return false;
+                    }
+                }
+
+                std::error_code ec;
+                std::filesystem::rename(tmp_path, path, ec);
+                return !ec;
+            }
+
+            void printStats() const {
+                std::array<u64, 3> counts{};
+                i32                longest = 0;
+                for (const Color c : {Color::WHITE, Color::BLACK})
+                {
+                    for (u64 i = 0; i < size; i++)
+                    {
+                        Squares squares;
+                        if (!isValid(c, i, &squares))
+                        {
+                            continue;
+                        }
+                        const ProbeResult result = fromValue(values[c][i]);
+                        counts[static_cast<int>(result.wdl) + 1]++;
+                        longest = std::max(longest, result.plies);
+                    }
+                }
+
+                std::cout << material.code() << ": " << counts[2] << " wins, " << counts[1]
+                          << " draws, " << counts[0] << " losses, longest mate " << longest
+                          << " plies" << std::endl;
+            }
+
+           private:
+            const Material&                  material;
+            const u64                        size;
+            std::array<Capture, MAX_PIECES>& captures;
+            std::array<std::vector<u8>, 2>   values;
+            std::array<std::vector<u8>, 2>   events;  // The pass a capture resolves the position
+            std::array<std::vector<u64>, 2>  candidates;
+            std::array<std::vector<u64>, 2>  changed;
+            std::atomic<i32>                 last_event{0};
+
+            static BitBoard occupancy(const Squares& squares, const int n) {
+                BitBoard occupied{};
+                for (int i = 0; i < n; i++)
+                {
+                    occupied |= BB(squares[i]);
+                }
+                return occupied;
+            }
+
+            // Attacked by the pieces of color by, but for the piece at skip
+            bool isAttacked(const Squares& squares,
+                            const Square   sq,
+                            const Color    by,
+                            const BitBoard occupied,
+                            const int      skip) const {
+                for (int i = 0; i < material.n; i++)
+                {
+                    if ((i != skip) && (material.colors[i] == by)
+                        && (attacksOf(material.types[i], squares[i], occupied) & BB(sq)))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            // Distinct squares, kings apart, the side not to move out of check and the index the
+            // position encodes to
+            bool isValid(const Color stm, const u64 index, Squares* squares) const {
+                decode(material, index, squares);
+                const BitBoard occupied = occupancy(*squares, material.n);
+                return (occupied.count() == material.n) && (encode(material, *squares) == index)
+                    && !(attacksOf(PieceType::KING, (*squares)[0], occupied) & BB((*squares)[1]))
+                    && !isAttacked(*squares, (*squares)[colorFlip(stm)], stm, occupied, -1);
+            }
+
+            // Calls fn(squares, captured) after each legal move, captured is -1 for quiet moves
+            template<typename Fn>
+            void forEachMove(const Squares& squares, const Color stm, Fn&& fn) const {
+                const BitBoard occupied = occupancy(squares, material.n);
+                for (int i = 0; i < material.n; i++)
+                {
+                    if (material.colors[i] != stm)
+                    {
+                        continue;
+                    }
+
+                    BitBoard targets = attacksOf(material.types[i], squares[i], occupied);
+                    while (targets)
+                    {
+                        const Square to = static_cast<Square>(targets.pop_lsb());
+
+                        int captured = -1;
+                        for (int j = 0; j < material.n; j++)
+                        {
+                            if (squares[j] == to)
+                            {
+                                captured = j;
+                            }
+                        }
+                        if ((captured >= 0) && (material.colors[captured] == stm))
+                        {
+                            continue;
+                        }
+
+                        Squares next = squares;
+                        next[i]      = to;
+
+                        const BitBoard next_occupied = (occupied ^ BB(squares[i])) | BB(to);
+                        if (!isAttacked(next, next[stm], colorFlip(stm), next_occupied, captured))
+                        {
+                            fn(next, captured);
+                        }
+                    }
+                }
+            }
+
+            // Of the position after a move, for the side to move there
+            u8 childValue(const Squares& next, const int captured, const Color stm) const {
+                const Color them = colorFlip(stm);
+                if (captured < 0)
+                {
+                    return values[them][encode(material, next)];
+                }
+
+                const Capture& capture = captures[captured];
+                if (!capture.table)
+                {
+                    return VALUE_DRAW;
+                }
+
+                const Material& child = capture.table->material();
+                const u8        flip  = capture.swapped ? 56 : 0;
+
+                Squares squares{};
+                for (int k = 0; k < child.n; k++)
+                {
+                    squares[k] = static_cast<Square>(next[capture.slots[k]] ^ flip);
+                }
+                return capture.table->value(capture.swapped ? stm : them, encode(child, squares));
+            }
+
+            void initialize(const Color stm, const u64 index) {
+                Squares squares;
+                if (!isValid(stm, index, &squares))
+                {
+                    values[stm][index] = VALUE_DRAW;
+                    return;
+                }
+
+                int moves  = 0;
+                u8  event  = 0;
+                i32 latest = 0;
+                forEachMove(squares, stm, [&](const Squares& next, const int captured) {
+                    moves++;
+                    if (captured < 0)
+                    {
+                        return;
+                    }
+
+                    const u8 value = childValue(next, captured, stm);
+                    if (value != VALUE_DRAW)
+                    {
+                        const u8 pass = static_cast<u8>(fromValue(value).plies + 1);
+                        event         = (event == 0) ? pass : std::min(event, pass);
+                        latest        = std::max(latest, static_cast<i32>(pass));
+                    }
+                });
+
+                i32 last = last_event.load(std::memory_order_relaxed);
+                while ((last < latest) && !last_event.compare_exchange_weak(last, latest))
+                {}
+
+                if (moves > 0)
+                {
+                    events[stm][index] = event;
+                    return;
+                }
+
+                const BitBoard occupied = occupancy(squares, material.n);
+                if (isAttacked(squares, squares[stm], colorFlip(stm), occupied, -1))
+                {
+                    values[stm][index] = VALUE_LOSS;
+                    changed[stm][index / 64] |= 1ULL << (index % 64);
+                }
+                else
+                {
+                    values[stm][index] = VALUE_DRAW;
+                }
+            }
+
+            // A win when a move mates in the pass, a loss when every move is mated earlier
+            u8 evaluate(const Color stm, const u64 index, const i32 pass, u8* event) const {
+                Squares squares;
+                decode(material, index, &squares);
+
+                i32  win      = MAX_PLIES + 1;
+                i32  loss     = 0;
+                bool all_lost = true;
+                *event        = 0;
+                forEachMove(squares, stm, [&](const Squares& next, const int captured) {
+                    const u8 value = childValue(next, captured, stm);
+                    if ((value == VALUE_UNKNOWN) || (value == VALUE_DRAW))
+                    {
+                        all_lost = false;
+                        return;
+                    }
+
+                    const ProbeResult result = fromValue(value);
+                    if (result.plies >= pass)
+                    {
+                        if (captured >= 0)
+                        {
+                            const u8 next_event = static_cast<u8>(result.plies + 1);
+                            *event = (*event == 0) ? next_event : std::min(*event, next_event);
+                        }
+                        all_lost = false;
+                        return;
+                    }
+
+                    if (result.wdl == WDL::LOSS)
+                    {
+                        win      = std::min(win, result.plies + 1);
+                        all_lost = false;
+                    }
+                    else
+                    {
+                        loss = std::max(loss, result.plies + 1);
+                    }
+                });
+
+                if (win <= pass)
+                {
+                    return toValue(ProbeResult{WDL::WIN, win});
+                }
+                if (all_lost)
+                {
+                    return toValue(ProbeResult{WDL::LOSS, loss});
+                }
+                return VALUE_UNKNOWN;
+            }
+
+            u64 resolve(const Color stm, const i32 pass, const u64 begin, const u64 end) {
+                u64 resolved = 0;
+                for (u64 i = begin; i < end; i++)
+                {
+                    const bool candidate = (candidates[stm][i / 64] >> (i % 64)) & 1;
+                    if ((values[stm][i] != VALUE_UNKNOWN)
+                        || (!candidate && (events[stm][i] != pass)))
+                    {
+                        continue;
+                    }
+
+                    u8       event;
+                    const u8 value = evaluate(stm, i, pass, &event);
+                    events[stm][i] = event;
+                    if (value != VALUE_UNKNOWN)
+                    {
+                        values[stm][i] = value;
+                        changed[stm][i / 64] |= 1ULL << (i % 64);
+                        resolved++;
+                    }
+                }
+
+                for (u64 w = begin / 64; w < (end + 63) / 64; w++)
+                {
+                    candidates[stm][w] = 0;
+                }
+                return resolved;
+            }
+
+            // Un-moves of the side that moved last, onto empty squares
+            void markPredecessors(const Color stm, const u64 index) {
+                const Color them = colorFlip(stm);
+
+                Squares squares;
+                decode(material, index, &squares);
+                const BitBoard occupied = occupancy(squares, material.n);
+
+                for (int i = 0; i < material.n; i++)
+                {
+                    if (material.colors[i] != them)
+                    {
+                        continue;
+                    }
+
+                    BitBoard from = attacksOf(material.types[i], squares[i], occupied) & ~occupied;
+                    while (from)
+                    {
+                        Squares prev = squares;
+                        prev[i]      = static_cast<Square>(from.pop_lsb());
+
+                        const u64 j = encode(material, prev);
+                        if (values[them][j] == VALUE_UNKNOWN)
+                        {
+                            std::atomic_ref<u64>(candidates[them][j / 64])
+                              .fetch_or(1ULL << (j % 64), std::memory_order_relaxed);
+                        }
+                    }
+                }
+            }
+        };
+
+        // The pieces left after the capture of piece captured, in the order of their table
+        bool prepareCapture(const Material&              material,
+                            const int                    captured,
+                            const std::filesystem::path& dir,
+                            Capture*                     capture);
+
+        bool generateTable(const Material& material, const std::filesystem::path& dir) {
+            const std::filesystem::path path = tablePath(dir, material);
+            if (std::filesystem::exists(path))
+            {
+                return true;
+            }
+
+            std::array<Capture, MAX_PIECES> captures{};
+            for (int i = 2; i < material.n; i++)
+            {
+                if (!prepareCapture(material, i, dir, &captures[i]))
+                {
+                    return false;
+                }
+            }
+
+            const u64 size = material.size();
+            std::cout << "Generating " << material.code() << ", " << (2 * size) << " positions, "
+                      << ((9 * size) / 2 >> 20) << " MiB" << std::endl;
+
+            Generator generator(material, captures);
+            if (!generator.run())
+            {
+                std::cout << "Mates of " << material.code() << " are too long for the table format"
+                          << std::endl;
+                return false;
+            }
+            if (!generator.write(path))
+            {
+                std::cout << "Could not write " << path.string() << std::endl;
+                return false;
+            }
+
+            generator.printStats();
+            return true;
+        }
+
+        bool prepareCapture(const Material&              material,
+                            const int                    captured,
+                            const std::filesystem::path& dir,
+                            Capture*                     capture) {
+            // Our pieces are in table order already, only the colors may swap
+            std::array<std::string, 2> sides = {"K", "K"};
+            for (int i = 2; i < material.n; i++)
+            {
+                if (i != captured)
+                {
+                    sides[material.colors[i]] += PIECE_CHARS[material.types[i]];
+                }
+            }
+
+            const std::string code = sides[Color::WHITE] + sides[Color::BLACK];
+            Material          child;
+            if (!Material::parse(code, &child))
+            {
+                return false;
+            }
+            if (child.n == 2)
+            {
+                return true;
+            }
+            if (!generateTable(child, dir))
+            {
+                return false;
+            }
+
+            capture->table = std::make_unique<Table>();
+            if (!capture->table->open(tablePath(dir, child)))
+            {
+                std::cout << "Could not open " << tablePath(dir, child).string() << std::endl;
+                return false;
+            }
+            capture->swapped = (child.code() != code);
+
+            std::array<bool, MAX_PIECES> used{};
+            used[captured] = true;
+            for (int k = 0; k < child.n; k++)
+            {
+                const Color c = capture->swapped ? colorFlip(child.colors[k]) : child.colors[k];
+                for (int i = 0; i < material.n; i++)
+                {
+                    if (!used[i] && (material.colors[i] == c)
+                        && (material.types[i] == child.types[k]))
+                    {
+                        used[i]           = true;
+                        capture->slots[k] = i;
+                        break;
+                    }
+                }
+            }
+            return true;
+        }
+
+        // Non increasing sequences of pieces other than pawns and kings
+        void pieceSets(const std::size_t         n,
+                       const std::string&        prefix,
+                       std::vector<std::string>* sets) {
+            sets->push_back(prefix);
+            if (prefix.size() == n)
+            {
+                return;
+            }
+            for (const char pc : std::string_view("QRBN"))
+            {
+                if (prefix.empty() || (PIECE_CHARS.find(pc) <= PIECE_CHARS.find(prefix.back())))
+                {
+                    pieceSets(n, prefix + pc, sets);
+                }
+            }
+        }
+
+    }
+
+    std::vector<std::string> materialsUpTo(const int n) {
+        std::vector<std::string> sets;
+        pieceSets(static_cast<std::size_t>(std::clamp(n, 2, MAX_PIECES) - 2), "", &sets);
+
+        std::vector<std::string> codes;
+        for (int pieces = 3; pieces <= std::min(n, MAX_PIECES); pieces++)
+        {
+            for (const std::string& white : sets)
+            {
+                for (const std::string& black : sets)
+                {
+                    Material material;
+                    if ((static_cast<int>(white.size() + black.size()) + 2 != pieces)
+                        || !Material::parse("K" + white + "K" + black, &material))
+                    {
+                        continue;
+                    }
+
+                    const std::string code = material.code();
+                    if (std::find(codes.begin(), codes.end(), code) == codes.end())
+                    {
+                        codes.push_back(code);
+                    }
+                }
+            }
+        }
+        return codes;
+    }
+
+    bool generate(const std::vector<std::string>& codes, const std::filesystem::path& dir) {
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+
+        for (const std::string& code : codes)
+        {
+            Material material;
+            if (!Material::parse(code, &material) || (material.n < 3))
+            {
+                std::cout << "Unknown material " << code << ", expected pawnless material like "
+                          << "KQKR of up to " << MAX_PIECES << " pieces" << std::endl;
+                return false;
+            }
+            if (!generateTable(material, dir))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <filesystem>
+#include "commons/pch.h"
+
+namespace sagittar::tb {
+
+    // Codes of every pawnless material of up to n pieces, e.g. "KQK" and "KRK" for 3
+    std::vector<std::string> materialsUpTo(const int n);
+
+    // Writes the table of each material to dir, after the tables its captures lead to. Tables
+    // already in dir are kept. False for an unknown material or a failed write.
+    bool generate(const std::vector<std::string>& codes, const std::filesystem::path& dir);
+
+}
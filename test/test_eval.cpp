@@ -3,7 +3,14 @@
 #include "core/position.h"
 #include "core/types.h"
 #include "doctest/doctest.h"
+#include "eval/evalcache.h"
 #include "eval/hce/defs.h"
+#include "eval/hce/attacks.h"
+#include "eval/hce/endgame.h"
+#include "eval/hce/eval.h"
+#include "eval/hce/kpk.h"
+#include "eval/hce/material.h"
+#include "eval/hce/pawns.h"
 
 using namespace sagittar;
 
@@ -105,4 +112,314 @@ TEST_SUITE("Eval") {
         CHECK(eval::hce::mg_score(score) == 100);
         CHECK(eval::hce::eg_score(score) == 200);
     }
+
+    TEST_CASE("eval::EvalCache") {
+        Position pos;
+        pos.setFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        const u64 key = pos.key();
+
+        Score eval = 0;
+
+        SUBCASE("disabled") {
+            eval::EvalCache cache(0);
+            cache.store(key, 42);
+            CHECK(!cache.probe(key, &eval));
+        }
+
+        SUBCASE("store and probe") {
+            eval::EvalCache cache(1);
+            CHECK(!cache.probe(key, &eval));
+
+            cache.store(key, eval::hce::evaluate(pos));
+            REQUIRE(cache.probe(key, &eval));
+            CHECK(eval == eval::hce::evaluate(pos));
+
+            cache.store(key, -1234);
+            REQUIRE(cache.probe(key, &eval));
+            CHECK(eval == -1234);
+
+            REQUIRE(pos.doMove("e1g1"));
+            CHECK(!cache.probe(pos.key(), &eval));
+
+            cache.clear();
+            CHECK(!cache.probe(key, &eval));
+        }
+    }
+
+    TEST_CASE("eval::endgames") {
+        Position pos;
+
+        const auto eval_of = [&pos](const std::string& fen) {
+            pos.setFen(fen);
+            return eval::hce::evaluate(pos);
+        };
+
+        SUBCASE("known wins") {
+            CHECK(eval_of("8/8/8/4k3/8/8/8/R3K3 w - - 0 1") >= eval::hce::KNOWN_WIN);
+            CHECK(eval_of("8/8/8/4k3/8/8/8/R3K3 b - - 0 1") <= -eval::hce::KNOWN_WIN);
+            CHECK(eval_of("q3k3/8/8/8/3K4/8/8/8 b - - 0 1") >= eval::hce::KNOWN_WIN);
+
+            // The lone king is pushed to the edge
+            const Score edge   = eval_of("7k/8/8/8/8/8/8/R3K3 w - - 0 1");
+            const Score center = eval_of("8/8/8/4k3/8/8/8/R3K3 w - - 0 1");
+            CHECK(edge > center);
+
+            // KBNK mates in the corners of the bishop's color
+            const Score right = eval_of("7k/8/5K2/8/8/8/8/4BN2 w - - 0 1");
+            const Score wrong = eval_of("k7/8/2K5/8/8/8/8/4BN2 w - - 0 1");
+            CHECK(wrong >= eval::hce::KNOWN_WIN);
+            CHECK(right > wrong);
+        }
+
+        SUBCASE("insufficient material") {
+            CHECK(eval_of("8/8/8/4k3/8/8/8/2B1K3 w - - 0 1") == 0);
+            CHECK(eval_of("8/8/8/4k3/8/8/8/1N2KN2 w - - 0 1") == 0);
+            CHECK(eval_of("8/8/2n5/4k3/8/8/8/2B1K3 b - - 0 1") == 0);
+        }
+
+        SUBCASE("KPK") {
+            // Defending king in front of the pawn
+            CHECK(std::abs(eval_of("8/8/8/4k3/4P3/4K3/8/8 w - - 0 1")) <= 10);
+            CHECK(std::abs(eval_of("8/8/4k3/4p3/4K3/8/8/8 b - - 0 1")) <= 10);
+            CHECK(eval_of("8/8/8/8/4P3/4K3/8/k7 w - - 0 1") > 50);
+
+            // Rook pawn, defending king in the corner
+            CHECK(std::abs(eval_of("k7/8/8/P7/8/8/8/4K3 w - - 0 1")) <= 10);
+            CHECK(eval_of("8/8/8/P7/8/8/8/4K2k w - - 0 1") > 50);
+
+            // Stalemate, or a win with white to move
+            CHECK(eval_of("4k3/4P3/4K3/8/8/8/8/8 b - - 0 1") == 0);
+            CHECK(eval_of("4k3/4P3/4K3/8/8/8/8/8 w - - 0 1") >= eval::hce::KNOWN_WIN - 200);
+            CHECK(eval_of("8/8/8/8/8/4k3/4p3/4K3 w - - 0 1") == 0);
+            CHECK(eval_of("8/8/8/8/8/4k3/4p3/4K3 b - - 0 1") >= eval::hce::KNOWN_WIN - 200);
+
+            // Outside the square of the pawn
+            CHECK(eval_of("8/8/2k5/6P1/8/8/8/K7 w - - 0 1") > eval::hce::KNOWN_WIN / 2);
+            CHECK(eval_of("8/8/2k5/6P1/8/8/8/K7 b - - 0 1") == 0);
+        }
+
+        SUBCASE("KPK bitbase") {
+            // The files are mirrored
+            using eval::hce::kpk::probe;
+            CHECK(probe(Square::E6, Square::E7, Square::E8, Color::WHITE));
+            CHECK(probe(Square::D6, Square::D7, Square::D8, Color::WHITE));
+            CHECK(!probe(Square::E6, Square::E7, Square::E8, Color::BLACK));
+            CHECK(!probe(Square::D6, Square::D7, Square::D8, Color::BLACK));
+
+            // Key squares, two ranks in front of the pawn, win whoever moves
+            for (const Color stm : {Color::WHITE, Color::BLACK})
+            {
+                CHECK(probe(Square::D5, Square::D3, Square::D7, stm));
+                CHECK(probe(Square::E5, Square::D3, Square::D7, stm));
+            }
+
+            // Opposition
+            CHECK(probe(Square::D4, Square::D3, Square::D6, Color::BLACK));
+            CHECK(!probe(Square::D4, Square::D3, Square::D6, Color::WHITE));
+        }
+
+        SUBCASE("opposite bishops") {
+            const Score opposite = eval_of("4k3/8/2b5/8/3PP3/8/8/2B1K3 w - - 0 1");
+            const Score same     = eval_of("4k3/8/3b4/8/3PP3/8/8/2B1K3 w - - 0 1");
+            CHECK(opposite > 0);
+            CHECK(opposite < same);
+        }
+    }
+
+    TEST_CASE("eval::MaterialTable") {
+        eval::hce::Caches caches;
+        caches.allocate();
+
+        Position pos;
+        pos.setFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+        const eval::hce::MaterialEntry& entry = caches.material.probe(pos);
+        CHECK(entry.key == pos.material_key());
+        CHECK(entry.phase == eval::hce::pos_phase(pos));
+        CHECK(!entry.hasEvaluator());
+        CHECK(!entry.endgame);
+        CHECK(entry.imbalance == 0);
+
+        CHECK(eval::hce::evaluate<Color::WHITE>(pos, caches) == eval::hce::evaluate(pos));
+        REQUIRE(pos.doMove("e2a6"));
+        CHECK(caches.material.probe(pos).imbalance == eval::hce::BISHOP_PAIR_BONUS);
+        CHECK(caches.material.probe(pos).endgame == false);
+        CHECK(eval::hce::evaluate<Color::BLACK>(pos, caches) == eval::hce::evaluate(pos));
+    }
+
+    TEST_CASE("eval::pawns") {
+        Position pos;
+
+        SUBCASE("structure") {
+            // White: passed a3, f3 and d5, doubled a-pawns, backward g2
+            // Black: passed c4, isolated c4 and h4
+            pos.setFen("4k3/8/8/3P4/2p4p/P4P2/P5PK/8 w - - 0 1");
+
+            eval::hce::EvalTrace trace;
+            const auto           entry = eval::hce::computePawns(pos, trace);
+
+            CHECK(entry.passed[Color::WHITE] == (BB(Square::A3) | BB(Square::F3) | BB(Square::D5)));
+            CHECK(entry.passed[Color::BLACK] == BB(Square::C4));
+            CHECK(trace.passed[Rank::RANK_3][Color::WHITE] == 2);
+            CHECK(trace.passed[Rank::RANK_5][Color::WHITE] == 1);
+            CHECK(trace.passed[Rank::RANK_5][Color::BLACK] == 1);
+
+            CHECK(trace.doubled[Color::WHITE] == 1);
+            CHECK(trace.doubled[Color::BLACK] == 0);
+            CHECK(trace.isolated[Color::WHITE] == 3);
+            CHECK(trace.isolated[Color::BLACK] == 2);
+            CHECK(trace.backward[Color::WHITE] == 1);
+            CHECK(trace.backward[Color::BLACK] == 0);
+            CHECK(trace.connected[Rank::RANK_3][Color::WHITE] == 1);
+
+            CHECK(entry.attacks[Color::WHITE] & BB(Square::B4));
+            CHECK(entry.attack_span[Color::BLACK] & BB(Square::B1));
+        }
+
+        SUBCASE("king shelter") {
+            pos.setFen("r5k1/5ppp/8/8/8/6P1/5P1P/6K1 w - - 0 1");
+            const auto entry = eval::hce::computePawns(pos);
+
+            // Intact shield against a weakened one, and no shield at all
+            const i32 black = entry.kingShelter(Color::BLACK, Square::G8);
+            const i32 white = entry.kingShelter(Color::WHITE, Square::G1);
+            CHECK(eval::hce::mg_score(black) > eval::hce::mg_score(white));
+            CHECK(eval::hce::mg_score(white)
+                  > eval::hce::mg_score(entry.kingShelter(Color::WHITE, Square::B1)));
+
+            // Shelter only depends on the king file
+            CHECK(entry.kingShelter(Color::BLACK, Square::G8)
+                  == entry.kingShelter(Color::BLACK, Square::G6));
+        }
+
+        SUBCASE("table") {
+            eval::hce::Caches caches;
+            caches.allocate();
+
+            pos.setFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+            const auto& entry = caches.pawns.probe(pos);
+            CHECK(entry.key == pos.pawn_key());
+            CHECK(entry.score == eval::hce::computePawns(pos).score);
+
+            // No pawns
+            pos.setFen("4k3/8/8/8/8/8/8/R3K3 w - - 0 1");
+            CHECK(caches.pawns.probe(pos).key == 0);
+            CHECK(caches.pawns.probe(pos).shelter == eval::hce::computePawns(pos).shelter);
+        }
+    }
+
+    TEST_CASE("eval::attacks") {
+        Position pos;
+
+        const auto trace_of = [&pos](const std::string& fen) {
+            pos.setFen(fen);
+            eval::hce::AttackInfo  ai;
+            eval::hce::EvalTrace trace;
+            eval::hce::evaluateAttacks(pos, eval::hce::computePawns(pos), ai, trace);
+            return trace;
+        };
+
+        SUBCASE("mobility") {
+            auto trace = trace_of("4k3/8/8/8/3N4/8/8/4K3 w - - 0 1");
+            CHECK(trace.mobility[0][8][Color::WHITE] == 1);
+
+            // Own pawns and king are not counted
+            trace = trace_of("4k3/8/8/8/8/8/P7/R3K3 w - - 0 1");
+            CHECK(trace.mobility[2][3][Color::WHITE] == 1);
+        }
+
+        SUBCASE("king zone") {
+            const auto trace = trace_of("4k3/8/8/8/8/4q3/8/4K3 w - - 0 1");
+            CHECK(trace.king_zone_attack[PieceType::QUEEN][Color::BLACK] == 4);
+            CHECK(trace.king_zone_attack[PieceType::QUEEN][Color::WHITE] == 0);
+        }
+
+        SUBCASE("threats") {
+            const auto trace = trace_of("4k3/8/8/3n4/4P3/8/8/4K3 w - - 0 1");
+            CHECK(trace.threat_by_pawn[PieceType::KNIGHT][Color::WHITE] == 1);
+            CHECK(trace.threat_by_minor[PieceType::PAWN][Color::BLACK] == 0);
+        }
+
+        SUBCASE("color symmetry") {
+            const std::array<std::pair<std::string, std::string>, 3> fens = {{
+              {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+               "r3k2r/pppbbppp/2n2q1P/1P2p3/3pn3/BN2PNP1/P1PPQPB1/R3K2R b KQkq - 0 1"},
+              {"r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP2BPPP/R2QKB1R w KQ - 0 1",
+               "r2qkb1r/pp2bppp/2n1pn2/2pp4/3P4/2N1PN2/PP2BPPP/R1BQ1RK1 b kq - 0 1"},
+              {"8/5pk1/6p1/3R4/8/6P1/r4PK1/8 b - - 0 1", "8/R4pk1/6p1/8/3r4/6P1/5PK1/8 w - - 0 1"},
+            }};
+
+            Position mirrored;
+            for (const auto& [fen, mirrored_fen] : fens)
+            {
+                pos.setFen(fen);
+                mirrored.setFen(mirrored_fen);
+                CHECK(eval::hce::evaluate(pos) == eval::hce::evaluate(mirrored));
+            }
+        }
+    }
+
+    TEST_CASE("eval::lazy") {
+        eval::hce::Caches caches;
+        caches.allocate();
+
+        Position pos;
+        pos.setFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+        const Score full    = eval::hce::evaluate(pos);
+        bool        is_lazy = true;
+
+        // Window around the eval, every term is needed
+        Score eval = eval::hce::evaluate<Color::WHITE>(pos, caches, {full - 1, full + 1, 100},
+                                                       &is_lazy);
+        CHECK(!is_lazy);
+        CHECK(eval == full);
+
+        // Far above and far below the window
+        eval = eval::hce::evaluate<Color::WHITE>(pos, caches, {-2000, -1900, 300}, &is_lazy);
+        CHECK(is_lazy);
+        CHECK(eval >= -1900 + 300);
+
+        eval = eval::hce::evaluate<Color::WHITE>(pos, caches, {1900, 2000, 300}, &is_lazy);
+        CHECK(is_lazy);
+        CHECK(eval <= 1900 - 300);
+
+        // Recognized endgames are exact and cheap
+        pos.setFen("8/8/8/4k3/8/8/8/R3K3 w - - 0 1");
+        eval = eval::hce::evaluate<Color::WHITE>(pos, caches, {-2000, -1900, 300}, &is_lazy);
+        CHECK(!is_lazy);
+        CHECK(eval == eval::hce::evaluate(pos));
+    }
+
+    TEST_CASE("eval::trace") {
+        Position pos;
+
+        for (const std::string fen : {
+               "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+               "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+               "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1",
+             })
+        {
+            pos.setFen(fen);
+
+            eval::hce::EvalTrace trace;
+            CHECK(eval::hce::evaluate(pos, trace) == eval::hce::evaluate(pos));
+            CHECK(trace.piece_counts[PieceType::PAWN][Color::WHITE] == 8);
+            CHECK(trace.piece_counts[PieceType::KING][Color::BLACK] == 1);
+            CHECK(trace.bishop_pair[Color::WHITE] == 1);
+        }
+
+        // Both colors count the same PSQT entry for mirrored pieces
+        pos.setFen("4k3/4p3/8/8/8/8/4P3/4K3 w - - 0 1");
+        eval::hce::EvalTrace trace;
+        eval::hce::evaluate(pos, trace);
+        for (int sq = 0; sq < 64; sq++)
+        {
+            for (const PieceType pt : {PieceType::PAWN, PieceType::KING})
+            {
+                CHECK(trace.psq_counts[pt][sq][Color::WHITE]
+                      == trace.psq_counts[pt][sq][Color::BLACK]);
+            }
+        }
+    }
 }
@@ -38,4 +38,65 @@ TEST_SUITE("Movegen") {
 
         CHECK(moves.size() == 20);
     }
+
+    TEST_CASE("pseudolegalMoves - check evasions") {
+        Position pos;
+        pos.setFen("4k3/8/8/8/8/8/8/r3K3 w - - 0 1");
+
+        containers::ArrayList<Move> moves;
+        pseudolegalMoves<MovegenType::CHECK_EVASIONS>(&moves, pos);
+
+        // All pseudolegal king moves, not only those on the check line
+        CHECK(moves.size() == 5);
+    }
+
+    TEST_CASE("pseudolegalMoves - pinned pieces") {
+        Position pos;
+        // The rook on e4 is pinned and can only move along the file
+        pos.setFen("4r2k/8/8/8/4R3/8/8/4K3 w - - 0 1");
+
+        containers::ArrayList<Move> moves;
+        pseudolegalMoves<MovegenType::ALL>(&moves, pos);
+
+        // Five king moves, Re2, Re3 and Re5 to Rxe8
+        CHECK(moves.size() == 5 + 6);
+
+        // In check, the pinned knight cannot block on c1
+        pos.setFen("4r2k/8/8/8/8/8/4N3/r3K3 w - - 0 1");
+
+        containers::ArrayList<Move> evasions;
+        pseudolegalMoves<MovegenType::CHECK_EVASIONS>(&evasions, pos);
+
+        // Kd1, Kd2, Kf1 and Kf2
+        CHECK(evasions.size() == 4);
+    }
+
+    TEST_CASE("pseudolegalMoves - quiet checks") {
+        Position pos;
+        pos.setFen("4k3/8/8/8/8/8/4P3/R2QK1N1 w - - 0 1");
+
+        containers::ArrayList<Move> moves;
+        pseudolegalMoves<MovegenType::QUIET_CHECKS>(&moves, pos);
+
+        // Ra8, Qd8, Qd7 and Qa4
+        REQUIRE(moves.size() == 4);
+
+        for (const auto& move : moves)
+        {
+            REQUIRE_FALSE(move.isCapture());
+            REQUIRE_FALSE(move.isPromotion());
+
+            Position pos_copy = pos;
+            REQUIRE(pos_copy.doMove(move));
+            REQUIRE(pos_copy.isInCheck());
+        }
+
+        pos.setFen("4k3/8/8/3P1N2/8/8/8/4K3 w - - 0 1");
+
+        containers::ArrayList<Move> knight_moves;
+        pseudolegalMoves<MovegenType::QUIET_CHECKS>(&knight_moves, pos);
+
+        // d6 is not a check, Nd6 and Ng7 are
+        REQUIRE(knight_moves.size() == 2);
+    }
 }
@@ -19,11 +19,15 @@ TEST_SUITE("Movepicker") {
         int capture_move_done_at = -1;
 
         const Move             pvmove(Square::E1, Square::F2, MoveFlag::MOVE_CAPTURE);
-        search::PieceToHistory history;
+        search::PieceToHistory        history{};
+        search::PieceToHistory        cont_history{};
+        const search::ContHistEntries cont_hist = {&cont_history, &cont_history};
+        search::CaptureHistory        capt_history{};
 
         std::array<ExtMove, MOVES_MAX> buffer{};
-        search::MovePicker move_picker(buffer.data(), pos, pvmove, history, NULL_MOVE, NULL_MOVE,
-                                       MovegenType::ALL);
+        search::MovePicker<Color::WHITE> move_picker(buffer.data(), pos, pvmove, history, cont_hist,
+                                                     capt_history, NULL_MOVE, NULL_MOVE, NULL_MOVE,
+                                                     MovegenType::ALL);
 
         while (move_picker.hasNext())
         {
@@ -78,13 +82,17 @@ TEST_SUITE("Movepicker") {
         int killer_move_done_at  = -1;
 
         const Move             pvmove(Square::D5, Square::E6, MoveFlag::MOVE_CAPTURE);
-        search::PieceToHistory history;
+        search::PieceToHistory        history{};
+        search::PieceToHistory        cont_history{};
+        const search::ContHistEntries cont_hist = {&cont_history, &cont_history};
+        search::CaptureHistory        capt_history{};
         const Move             killers1{Square::F3, Square::D3, MoveFlag::MOVE_QUIET};
         const Move             killers2{Square::D2, Square::E3, MoveFlag::MOVE_QUIET};
 
         std::array<ExtMove, MOVES_MAX> buffer{};
-        search::MovePicker move_picker(buffer.data(), pos, pvmove, history, killers1, killers2,
-                                       MovegenType::ALL);
+        search::MovePicker<Color::WHITE> move_picker(buffer.data(), pos, pvmove, history, cont_hist,
+                                                     capt_history, killers1, killers2, NULL_MOVE,
+                                                     MovegenType::ALL);
 
         while (move_picker.hasNext())
         {
@@ -149,11 +157,15 @@ TEST_SUITE("Movepicker") {
         int i = 0;
 
         const Move             pvmove(Square::E1, Square::F2, MoveFlag::MOVE_CAPTURE);
-        search::PieceToHistory history;
+        search::PieceToHistory        history{};
+        search::PieceToHistory        cont_history{};
+        const search::ContHistEntries cont_hist = {&cont_history, &cont_history};
+        search::CaptureHistory        capt_history{};
 
         std::array<ExtMove, MOVES_MAX> buffer{};
-        search::MovePicker move_picker(buffer.data(), pos, pvmove, history, NULL_MOVE, NULL_MOVE,
-                                       MovegenType::CAPTURES);
+        search::MovePicker<Color::WHITE> move_picker(buffer.data(), pos, pvmove, history, cont_hist,
+                                                     capt_history, NULL_MOVE, NULL_MOVE, NULL_MOVE,
+                                                     MovegenType::CAPTURES);
         while (move_picker.hasNext())
         {
             const Move move = move_picker.next();
@@ -177,4 +189,135 @@ TEST_SUITE("Movepicker") {
         // Check if all moves are processed
         REQUIRE(i == move_picker.size());
     }
+
+    TEST_CASE("movepicker::next::all with Counter move") {
+        Position pos;
+        pos.setFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+        int i               = 0;
+        int counter_move_at = -1;
+        int first_killer_at = -1;
+        int first_quiet_at  = -1;
+
+        const Move                    pvmove(Square::D5, Square::E6, MoveFlag::MOVE_CAPTURE);
+        search::PieceToHistory        history{};
+        search::PieceToHistory        cont_history{};
+        const search::ContHistEntries cont_hist = {&cont_history, &cont_history};
+        search::CaptureHistory        capt_history{};
+        const Move                    killers1{Square::F3, Square::D3, MoveFlag::MOVE_QUIET};
+        const Move                    counter{Square::E1, Square::D1, MoveFlag::MOVE_QUIET};
+
+        // Continuation history should order quiets even if the main history is empty. It also
+        // has to outweigh the bonus of the knight on c3 escaping the pawn on b4.
+        const Move best_quiet{Square::A2, Square::A3, MoveFlag::MOVE_QUIET};
+        cont_history[Piece::WHITE_PAWN][Square::A3] = 8192;
+
+        std::array<ExtMove, MOVES_MAX> buffer{};
+        search::MovePicker<Color::WHITE> move_picker(buffer.data(), pos, pvmove, history, cont_hist,
+                                                     capt_history, killers1, NULL_MOVE, counter,
+                                                     MovegenType::ALL);
+
+        while (move_picker.hasNext())
+        {
+            const Move move = move_picker.next();
+
+            if (move == killers1)
+            {
+                REQUIRE(move_picker.phase() == search::MovePickerPhase::KILLERS);
+                first_killer_at = i;
+            }
+            else if (move == counter)
+            {
+                REQUIRE(move_picker.phase() == search::MovePickerPhase::COUNTER_MOVE);
+                counter_move_at = i;
+            }
+            else if (!move.isCapture() && move != pvmove)
+            {
+                REQUIRE(move_picker.phase() == search::MovePickerPhase::QUIETS);
+                if (first_quiet_at == -1)
+                {
+                    first_quiet_at = i;
+                    REQUIRE(move == best_quiet);
+                }
+            }
+
+            ++i;
+        }
+
+        REQUIRE(first_killer_at != -1);
+        REQUIRE(counter_move_at == first_killer_at + 1);
+        REQUIRE(first_quiet_at == counter_move_at + 1);
+
+        // Check if all moves are processed
+        REQUIRE(static_cast<std::size_t>(i) == move_picker.size());
+    }
+
+    TEST_CASE("movepicker::next::captures with Capture history") {
+        Position pos;
+        pos.setFen("4k3/8/8/1r1q1n1p/2B1P1P1/2N5/5q2/1R1RK3 w - - 0 1");
+
+        const Move                    pvmove(Square::E1, Square::F2, MoveFlag::MOVE_CAPTURE);
+        search::PieceToHistory        history{};
+        search::PieceToHistory        cont_history{};
+        const search::ContHistEntries cont_hist = {&cont_history, &cont_history};
+        search::CaptureHistory        capt_history{};
+
+        // Without history, the least valuable attacker captures the queen first
+        {
+            std::array<ExtMove, MOVES_MAX> buffer{};
+            search::MovePicker<Color::WHITE> move_picker(buffer.data(), pos, pvmove, history,
+                                                         cont_hist, capt_history, NULL_MOVE,
+                                                         NULL_MOVE, NULL_MOVE,
+                                                         MovegenType::CAPTURES);
+            REQUIRE(move_picker.next() == pvmove);
+            REQUIRE(move_picker.next() == Move(Square::E4, Square::D5, MoveFlag::MOVE_CAPTURE));
+        }
+
+        // A rook capturing a queen on d5 has been successful before
+        capt_history[Piece::WHITE_ROOK][Square::D5][PieceType::QUEEN] = search::MAX_HISTORY;
+
+        {
+            std::array<ExtMove, MOVES_MAX> buffer{};
+            search::MovePicker<Color::WHITE> move_picker(buffer.data(), pos, pvmove, history,
+                                                         cont_hist, capt_history, NULL_MOVE,
+                                                         NULL_MOVE, NULL_MOVE,
+                                                         MovegenType::CAPTURES);
+            REQUIRE(move_picker.next() == pvmove);
+            REQUIRE(move_picker.next() == Move(Square::D1, Square::D5, MoveFlag::MOVE_CAPTURE));
+
+            // History must not lift a capture of a lesser victim above the queen captures
+            for (int i = 0; i < 3; i++)
+            {
+                const Move move = move_picker.next();
+                REQUIRE(move.to() == Square::D5);
+            }
+        }
+    }
+
+    TEST_CASE("movepicker::next::quiets escaping a threat") {
+        Position pos;
+        // The knight on d4 is attacked by the pawn on c5
+        pos.setFen("4k3/8/8/2p5/3N4/8/8/4K3 w - - 0 1");
+
+        search::PieceToHistory        history{};
+        search::PieceToHistory        cont_history{};
+        const search::ContHistEntries cont_hist = {&cont_history, &cont_history};
+        search::CaptureHistory        capt_history{};
+
+        std::array<ExtMove, MOVES_MAX> buffer{};
+        search::MovePicker<Color::WHITE> move_picker(buffer.data(), pos, NULL_MOVE, history,
+                                                     cont_hist, capt_history, NULL_MOVE, NULL_MOVE,
+                                                     NULL_MOVE, MovegenType::ALL);
+
+        // All eight knight moves come before the king moves
+        for (int i = 0; i < 8; i++)
+        {
+            REQUIRE(move_picker.hasNext());
+            REQUIRE(move_picker.next().from() == Square::D4);
+        }
+        while (move_picker.hasNext())
+        {
+            REQUIRE(move_picker.next().from() == Square::E1);
+        }
+    }
 }
@@ -0,0 +1,188 @@
+#include <cctype>
+#include <cstring>
+#include <random>
+#include "commons/containers.h"
+#include "commons/pch.h"
+#include "core/movegen.h"
+#include "core/position.h"
+#include "core/types.h"
+#include "doctest/doctest.h"
+#include "eval/nnue/nnue.h"
+
+using namespace sagittar;
+
+namespace {
+
+    // Serialized network with random parameters, small enough for the output layer kernel
+    std::vector<std::byte> randomNetwork(const int output_lo = -100, const int output_hi = 100) {
+        using namespace eval::nnue;
+
+        const std::array<u32, 5> header = {NETWORK_MAGIC, NETWORK_VERSION, KING_BUCKETS, L1_SIZE,
+                                           OUTPUT_BUCKETS};
+
+        std::vector<i16> params;
+        std::mt19937     rng(1234);
+        const auto       fill = [&](const std::size_t n, const int lo, const int hi) {
+            std::uniform_int_distribution<int> dist(lo, hi);
+            for (std::size_t i = 0; i < n; i++)
+            {
+                params.push_back(static_cast<i16>(dist(rng)));
+            }
+        };
+        fill(INPUT_SIZE * L1_SIZE, -32, 32);
+        fill(L1_SIZE, 0, 64);
+        fill(OUTPUT_BUCKETS * 2 * L1_SIZE, output_lo, output_hi);
+        fill(OUTPUT_BUCKETS, -500, 500);
+
+        std::vector<std::byte> data(sizeof(header) + (params.size() * sizeof(i16)));
+        std::memcpy(data.data(), header.data(), sizeof(header));
+        std::memcpy(data.data() + sizeof(header), params.data(), params.size() * sizeof(i16));
+        return data;
+    }
+
+    // Same position with colors swapped and the board flipped vertically
+    std::string mirrorFen(const std::string& fen) {
+        std::istringstream iss(fen);
+        std::string        board, stm, castling, ep, halfmove, fullmove;
+        iss >> board >> stm >> castling >> ep >> halfmove >> fullmove;
+
+        std::vector<std::string> ranks;
+        std::istringstream       board_ss(board);
+        for (std::string rank; std::getline(board_ss, rank, '/');)
+        {
+            ranks.push_back(rank);
+        }
+        std::reverse(ranks.begin(), ranks.end());
+
+        const auto swap_case = [](std::string s) {
+            for (auto& c : s)
+            {
+                c = std::isupper(c) ? std::tolower(c) : std::toupper(c);
+            }
+            return s;
+        };
+
+        std::string mirrored;
+        for (const auto& rank : ranks)
+        {
+            mirrored += (mirrored.empty() ? "" : "/") + swap_case(rank);
+        }
+        if (ep != "-")
+        {
+            ep[1] = (ep[1] == '3') ? '6' : '3';
+        }
+
+        return mirrored + ((stm == "w") ? " b " : " w ") + swap_case(castling) + " " + ep + " "
+             + halfmove + " " + fullmove;
+    }
+
+    void verifyUpdates(const Position& pos, const eval::nnue::Accumulator& acc, const int depth) {
+        containers::ArrayList<Move> moves;
+        pseudolegalMoves<MovegenType::ALL>(&moves, pos);
+        for (const auto& move : moves)
+        {
+            const Piece moved    = pos.pieceOn(move.from());
+            const Piece captured = pos.pieceOn(move.to());
+
+            Position pos_copy = pos;
+            if (!pos_copy.doMove(move))
+            {
+                continue;
+            }
+
+            eval::nnue::Accumulator updated, refreshed;
+            eval::nnue::update(updated, acc, pos_copy, move, moved, captured);
+            eval::nnue::refresh(refreshed, pos_copy);
+            REQUIRE(updated.values == refreshed.values);
+
+            if (depth > 1)
+            {
+                verifyUpdates(pos_copy, updated, depth - 1);
+            }
+        }
+    }
+
+}
+
+TEST_SUITE("NNUE") {
+
+    TEST_CASE("nnue::loadNetwork") {
+        const auto data = randomNetwork();
+
+        SUBCASE("rejects truncated data") {
+            CHECK(!eval::nnue::loadNetwork(std::span<const std::byte>(data).first(data.size() - 2)));
+        }
+
+        SUBCASE("rejects a wrong header") {
+            auto corrupted = data;
+            corrupted[0]   = std::byte{0};
+            CHECK(!eval::nnue::loadNetwork(std::span<const std::byte>(corrupted)));
+        }
+
+        SUBCASE("rejects a missing file") {
+            CHECK(!eval::nnue::loadNetwork(std::string("does/not/exist.nnue")));
+        }
+
+        SUBCASE("accepts a well formed network") {
+            CHECK(eval::nnue::loadNetwork(std::span<const std::byte>(data)));
+            CHECK(eval::nnue::isLoaded());
+        }
+    }
+
+    TEST_CASE("nnue::featureIndex") {
+        // A white pawn on e2 seen by white is a black pawn on e7 seen by black
+        CHECK(eval::nnue::featureIndex(Color::WHITE, Square::E1, Piece::WHITE_PAWN, Square::E2)
+              == eval::nnue::featureIndex(Color::BLACK, Square::E8, Piece::BLACK_PAWN, Square::E7));
+        // Kings on either wing of the back rank use different buckets
+        CHECK(eval::nnue::featureIndex(Color::WHITE, Square::B1, Piece::WHITE_PAWN, Square::E2)
+              != eval::nnue::featureIndex(Color::WHITE, Square::G1, Piece::WHITE_PAWN, Square::E2));
+    }
+
+    TEST_CASE("nnue::update matches refresh") {
+        const auto data = randomNetwork();
+        REQUIRE(eval::nnue::loadNetwork(std::span<const std::byte>(data)));
+
+        Position pos;
+        for (const auto& fen :
+             {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+              "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+              "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+              "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+              "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"})
+        {
+            pos.setFen(fen);
+            eval::nnue::Accumulator acc;
+            eval::nnue::refresh(acc, pos);
+            verifyUpdates(pos, acc, 2);
+        }
+    }
+
+    TEST_CASE("nnue::evaluate stays below the win scores") {
+        // Output weights at the top of the i16 product range
+        const auto data = randomNetwork(127, 127);
+        REQUIRE(eval::nnue::loadNetwork(std::span<const std::byte>(data)));
+
+        Position pos;
+        pos.setFen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+        CHECK(eval::nnue::evaluate(pos) == eval::nnue::MAX_EVAL);
+    }
+
+    TEST_CASE("nnue::evaluate is color symmetric") {
+        const auto data = randomNetwork();
+        REQUIRE(eval::nnue::loadNetwork(std::span<const std::byte>(data)));
+
+        Position pos, mirrored;
+        for (const auto& fen :
+             {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+              "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+              "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+              "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+              "4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1"})
+        {
+            pos.setFen(fen);
+            mirrored.setFen(mirrorFen(fen));
+            CHECK(eval::nnue::evaluate(pos) == eval::nnue::evaluate(mirrored));
+        }
+    }
+
+}
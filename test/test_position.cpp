@@ -1,5 +1,7 @@
+#include "commons/containers.h"
 #include "commons/pch.h"
 #include "core/move.h"
+#include "core/movegen.h"
 #include "core/position.h"
 #include "core/types.h"
 #include "doctest/doctest.h"
@@ -163,57 +165,134 @@ TEST_SUITE("Position") {
         CHECK(pos_copy.pieceOn(Square::B8) == Piece::WHITE_QUEEN);
     }
 
+    TEST_CASE("Position::non_pawn_key") {
+        Position pos;
+        pos.setFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+        const u64 pawn_key = pos.pawn_key();
+        const u64 w_key    = pos.non_pawn_key(Color::WHITE);
+        const u64 b_key    = pos.non_pawn_key(Color::BLACK);
+        CHECK(w_key != b_key);
+
+        // Piece move only changes the mover's non-pawn key
+        Position pos_copy = pos;
+        CHECK(pos_copy.doMove("c3b1"));
+        CHECK(pos_copy.pawn_key() == pawn_key);
+        CHECK(pos_copy.non_pawn_key(Color::WHITE) != w_key);
+        CHECK(pos_copy.non_pawn_key(Color::BLACK) == b_key);
+
+        // Pawn move only changes the pawn key
+        pos_copy = pos;
+        CHECK(pos_copy.doMove("a2a3"));
+        CHECK(pos_copy.pawn_key() != pawn_key);
+        CHECK(pos_copy.non_pawn_key(Color::WHITE) == w_key);
+        CHECK(pos_copy.non_pawn_key(Color::BLACK) == b_key);
+
+        // Capture of a piece changes both non-pawn keys
+        pos_copy = pos;
+        CHECK(pos_copy.doMove("e2a6"));
+        CHECK(pos_copy.pawn_key() == pawn_key);
+        CHECK(pos_copy.non_pawn_key(Color::WHITE) != w_key);
+        CHECK(pos_copy.non_pawn_key(Color::BLACK) != b_key);
+
+        // Keys are a function of the piece placement only
+        pos_copy = pos;
+        CHECK(pos_copy.doMove("c3b1"));
+        CHECK(pos_copy.doMove("a6b7"));
+        CHECK(pos_copy.doMove("b1c3"));
+        CHECK(pos_copy.doMove("b7a6"));
+        CHECK(pos_copy.non_pawn_key(Color::WHITE) == w_key);
+        CHECK(pos_copy.non_pawn_key(Color::BLACK) == b_key);
+    }
+
+    TEST_CASE("Position::material_key") {
+        Position pos;
+        pos.setFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+        const u64 key = pos.material_key();
+
+        // Moves that keep the piece counts keep the key
+        Position pos_copy = pos;
+        CHECK(pos_copy.doMove("c3b1"));
+        CHECK(pos_copy.doMove("a6b7"));
+        CHECK(pos_copy.doMove("a2a3"));
+        CHECK(pos_copy.material_key() == key);
+
+        // Same piece counts, different placement
+        Position other;
+        other.setFen("r3k2r/pbppqp2/1n2pnpb/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        CHECK(other.material_key() == key);
+
+        // Captures, en passant and promotions match a key computed from scratch
+        const auto check_move = [](const std::string& fen, const std::string& move) {
+            Position p;
+            p.setFen(fen);
+            const u64 before = p.material_key();
+            REQUIRE(p.doMove(move));
+            CHECK(p.material_key() != before);
+
+            Position fresh;
+            fresh.setFen(p.toFen());
+            CHECK(p.material_key() == fresh.material_key());
+        };
+
+        check_move("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", "e2a6");
+        check_move("8/8/8/3pP3/8/8/8/K6k w - d6 0 1", "e5d6");
+        check_move("8/4P3/8/8/8/8/8/K6k w - - 0 1", "e7e8q");
+        check_move("3r4/4P3/8/8/8/8/8/K6k w - - 0 1", "e7d8n");
+    }
+
     TEST_CASE("Position::isDrawn") {
-        std::vector<u64> key_history;
+        KeyHistory key_history;
 
         Position pos;
         pos.setFen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
 
         const u64 startpos_hash = pos.key();
 
-        key_history.push_back(pos.key());
+        key_history.push(pos.key());
         bool is_valid = pos.doMove("g1f3");
         CHECK(is_valid);
         CHECK(pos.isDrawn(key_history) == false);
         CHECK(pos.stm() == Color::BLACK);
 
-        key_history.push_back(pos.key());
+        key_history.push(pos.key());
         is_valid = pos.doMove("g8f6");
         CHECK(is_valid);
         CHECK(pos.isDrawn(key_history) == false);
         CHECK(pos.stm() == Color::WHITE);
 
-        key_history.push_back(pos.key());
+        key_history.push(pos.key());
         is_valid = pos.doMove("f3g1");
         CHECK(is_valid);
         CHECK(pos.isDrawn(key_history) == false);
         CHECK(pos.stm() == Color::BLACK);
 
-        key_history.push_back(pos.key());
+        key_history.push(pos.key());
         is_valid = pos.doMove("f6g8");
         CHECK(is_valid);
         CHECK(pos.isDrawn(key_history) == true);
         CHECK(pos.stm() == Color::WHITE);
 
-        key_history.push_back(pos.key());
+        key_history.push(pos.key());
         is_valid = pos.doMove("g1f3");
         CHECK(is_valid);
         CHECK(pos.isDrawn(key_history) == true);
         CHECK(pos.stm() == Color::BLACK);
 
-        key_history.push_back(pos.key());
+        key_history.push(pos.key());
         is_valid = pos.doMove("g8f6");
         CHECK(is_valid);
         CHECK(pos.isDrawn(key_history) == true);
         CHECK(pos.stm() == Color::WHITE);
 
-        key_history.push_back(pos.key());
+        key_history.push(pos.key());
         is_valid = pos.doMove("f3g1");
         CHECK(is_valid);
         CHECK(pos.isDrawn(key_history) == true);
         CHECK(pos.stm() == Color::BLACK);
 
-        key_history.push_back(pos.key());
+        key_history.push(pos.key());
         is_valid = pos.doMove("f6g8");
         CHECK(is_valid);
         CHECK(pos.isDrawn(key_history) == true);
@@ -221,4 +300,201 @@ TEST_SUITE("Position") {
 
         CHECK(pos.key() == startpos_hash);
     }
+
+    TEST_CASE("KeyHistory") {
+        const std::vector<u64> game = {1, 2, 3};
+
+        KeyHistory key_history(game);
+        CHECK(key_history.size() == 3);
+        CHECK(key_history.pliesAgo(1) == 3);
+
+        key_history.push(4);
+        key_history.push(5);
+        CHECK(key_history.size() == 5);
+        CHECK(key_history.pliesAgo(1) == 5);
+        CHECK(key_history.pliesAgo(2) == 4);
+        CHECK(key_history.pliesAgo(3) == 3);
+        CHECK(key_history.pliesAgo(5) == 1);
+
+        key_history.pop();
+        CHECK(key_history.size() == 4);
+        CHECK(key_history.pliesAgo(1) == 4);
+    }
+
+    TEST_CASE("Position::hasUpcomingRepetition") {
+        KeyHistory key_history;
+
+        Position pos;
+        pos.setFen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+
+        key_history.push(pos.key());
+        CHECK(pos.doMove("g1f3"));
+        CHECK(pos.hasUpcomingRepetition(key_history, 10) == false);
+
+        key_history.push(pos.key());
+        CHECK(pos.doMove("g8f6"));
+        CHECK(pos.hasUpcomingRepetition(key_history, 10) == false);
+
+        key_history.push(pos.key());
+        CHECK(pos.doMove("f3g1"));
+        // f6g8 brings back the start position
+        CHECK(pos.hasUpcomingRepetition(key_history, 10) == true);
+        // The cycle reaches back beyond the root
+        CHECK(pos.hasUpcomingRepetition(key_history, 3) == false);
+
+        key_history.push(pos.key());
+        CHECK(pos.doMove("e7e5"));
+        // A pawn move is irreversible
+        CHECK(pos.hasUpcomingRepetition(key_history, 10) == false);
+    }
+
+    TEST_CASE("Position::hasUpcomingRepetition blocked path") {
+        // Ra4-a1 would bring back the start position, unless the knight blocks the a-file
+        for (const auto& [fen, expected] :
+             {std::pair{"7k/8/8/8/8/2N5/8/R6K w - - 0 1", true},
+              std::pair{"7k/8/8/8/8/8/N7/R6K w - - 0 1", false}})
+        {
+            KeyHistory key_history;
+
+            Position pos;
+            pos.setFen(fen);
+
+            for (const auto& move : {"a1b1", "h8g8", "b1b4", "g8h8", "b4a4"})
+            {
+                key_history.push(pos.key());
+                CHECK(pos.doMove(move));
+            }
+
+            CHECK(pos.hasUpcomingRepetition(key_history, 10) == expected);
+        }
+    }
+
+    TEST_CASE("Position::givesCheck") {
+        Position pos;
+
+        SUBCASE("discovered check") {
+            pos.setFen("4k3/8/8/8/8/8/4N3/4R1K1 w - - 0 1");
+            CHECK(pos.givesCheck(Move(Square::E2, Square::C3, MoveFlag::MOVE_QUIET)));
+            CHECK(pos.givesCheck(Move(Square::E2, Square::G3, MoveFlag::MOVE_QUIET)));
+            CHECK(!pos.givesCheck(Move(Square::G1, Square::G2, MoveFlag::MOVE_QUIET)));
+        }
+
+        SUBCASE("castling") {
+            pos.setFen("5k2/8/8/8/8/8/8/4K2R w K - 0 1");
+            CHECK(pos.givesCheck(Move(Square::E1, Square::G1, MoveFlag::MOVE_CASTLE_KING_SIDE)));
+            CHECK(!pos.givesCheck(Move(Square::E1, Square::E2, MoveFlag::MOVE_QUIET)));
+        }
+
+        SUBCASE("en passant uncovers a slider") {
+            pos.setFen("6k1/8/8/3pP3/8/8/B7/7K w - d6 0 1");
+            CHECK(pos.givesCheck(Move(Square::E5, Square::D6, MoveFlag::MOVE_CAPTURE_EP)));
+            CHECK(!pos.givesCheck(Move(Square::E5, Square::E6, MoveFlag::MOVE_QUIET)));
+        }
+
+        SUBCASE("promotion") {
+            pos.setFen("3k4/1P6/8/8/8/8/8/4K3 w - - 0 1");
+            CHECK(pos.givesCheck(Move(Square::B7, Square::B8, MoveFlag::MOVE_PROMOTION_QUEEN)));
+            CHECK(pos.givesCheck(Move(Square::B7, Square::B8, MoveFlag::MOVE_PROMOTION_ROOK)));
+            CHECK(!pos.givesCheck(Move(Square::B7, Square::B8, MoveFlag::MOVE_PROMOTION_BISHOP)));
+            CHECK(!pos.givesCheck(Move(Square::B7, Square::B8, MoveFlag::MOVE_PROMOTION_KNIGHT)));
+        }
+
+        SUBCASE("agrees with making the move") {
+            const auto verify = [](auto&& self, const Position& pos, const int depth) -> void {
+                containers::ArrayList<Move> moves;
+                pseudolegalMoves<MovegenType::ALL>(&moves, pos);
+                for (const auto& move : moves)
+                {
+                    Position pos_copy = pos;
+                    if (!pos_copy.doMove(move))
+                    {
+                        continue;
+                    }
+                    REQUIRE(pos.givesCheck(move) == pos_copy.isInCheck());
+                    if (depth > 1)
+                    {
+                        self(self, pos_copy, depth - 1);
+                    }
+                }
+            };
+
+            for (const auto& fen :
+                 {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                  "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+                  "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                  "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"})
+            {
+                pos.setFen(fen);
+                verify(verify, pos, 3);
+            }
+        }
+    }
+
+    TEST_CASE("Position::threats") {
+        Position pos;
+        // The white knight on e2 is pinned by the rook on e8, the black pawn on c6 shields the
+        // black king from the bishop on d5
+        pos.setFen("4r3/1k6/2p5/3B4/6n1/5P2/4N3/4K3 w - - 0 1");
+
+        CHECK(pos.kingBlockers(Color::WHITE) == BB(Square::E2));
+        CHECK(pos.pinned(Color::WHITE) == BB(Square::E2));
+        CHECK(pos.kingBlockers(Color::BLACK) == BB(Square::C6));
+        CHECK(pos.pinned(Color::BLACK) == BB(Square::C6));
+
+        // The black knight is attacked by a pawn, the rook by nothing of lower value
+        CHECK(pos.lowerValueThreats(Color::BLACK, PieceType::KNIGHT) & BB(Square::G4));
+        CHECK(!(pos.lowerValueThreats(Color::BLACK, PieceType::ROOK) & BB(Square::E8)));
+        // The white bishop is attacked by a pawn, a rook on f6 would be attacked by the knight
+        CHECK(pos.lowerValueThreats(Color::WHITE, PieceType::BISHOP) & BB(Square::D5));
+        CHECK(pos.lowerValueThreats(Color::WHITE, PieceType::ROOK) & BB(Square::F6));
+        CHECK(!(pos.lowerValueThreats(Color::WHITE, PieceType::KNIGHT) & BB(Square::F6)));
+        CHECK(pos.lowerValueThreats(Color::WHITE, PieceType::PAWN) == BitBoard{});
+
+        // Maps follow the moves
+        REQUIRE(pos.doMove("d5c6"));
+        CHECK(pos.pinned(Color::BLACK) == BitBoard{});
+        CHECK(pos.kingBlockers(Color::WHITE) == BB(Square::E2));
+    }
+
+    TEST_CASE("Position::psqt and Position::phase") {
+        Position pos;
+        pos.setFen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+
+        // Symmetric position
+        CHECK(pos.psqt() == 0);
+        CHECK(pos.phase() == 24);
+
+        // Incremental updates agree with a position set up from scratch
+        const auto verify = [](auto&& self, const Position& pos, const int depth) -> void {
+            containers::ArrayList<Move> moves;
+            pseudolegalMoves<MovegenType::ALL>(&moves, pos);
+            for (const auto& move : moves)
+            {
+                Position pos_copy = pos;
+                if (!pos_copy.doMove(move))
+                {
+                    continue;
+                }
+
+                Position fresh;
+                fresh.setFen(pos_copy.toFen());
+                REQUIRE(pos_copy.psqt() == fresh.psqt());
+                REQUIRE(pos_copy.phase() == fresh.phase());
+
+                if (depth > 1)
+                {
+                    self(self, pos_copy, depth - 1);
+                }
+            }
+        };
+
+        for (const auto& fen :
+             {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+              "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+              "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1"})
+        {
+            pos.setFen(fen);
+            verify(verify, pos, 2);
+        }
+    }
 }
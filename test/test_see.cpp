@@ -0,0 +1,64 @@
+#include "core/move.h"
+#include "core/position.h"
+#include "core/types.h"
+#include "doctest/doctest.h"
+#include "search/see.h"
+
+using namespace sagittar;
+
+TEST_SUITE("SEE") {
+
+    TEST_CASE("see - undefended capture") {
+        Position pos;
+        pos.setFen("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1");
+
+        const Move move(Square::E1, Square::E5, MoveFlag::MOVE_CAPTURE);
+
+        REQUIRE(search::see(pos, move, 0));
+        REQUIRE(search::see(pos, move, 100));
+        REQUIRE_FALSE(search::see(pos, move, 101));
+    }
+
+    TEST_CASE("see - losing exchange") {
+        Position pos;
+        pos.setFen("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1");
+
+        const Move move(Square::D3, Square::E5, MoveFlag::MOVE_CAPTURE);
+
+        REQUIRE_FALSE(search::see(pos, move, 0));
+        REQUIRE(search::see(pos, move, -200));
+    }
+
+    TEST_CASE("see - quiet move to an attacked square") {
+        Position pos;
+        pos.setFen("4k3/8/8/4p3/8/8/8/2B1K3 w - - 0 1");
+
+        const Move safe(Square::C1, Square::D2, MoveFlag::MOVE_QUIET);
+        const Move hanging(Square::C1, Square::F4, MoveFlag::MOVE_QUIET);
+
+        REQUIRE(search::see(pos, safe, 0));
+        REQUIRE_FALSE(search::see(pos, hanging, 0));
+        REQUIRE(search::see(pos, hanging, -300));
+    }
+
+    TEST_CASE("see - x-ray recapture") {
+        Position pos;
+        pos.setFen("3r2k1/8/8/3p4/8/8/3R4/3RK3 w - - 0 1");
+
+        // RxP RxR RxR wins a pawn thanks to the rook behind
+        const Move move(Square::D2, Square::D5, MoveFlag::MOVE_CAPTURE);
+
+        REQUIRE(search::see(pos, move, 100));
+        REQUIRE_FALSE(search::see(pos, move, 101));
+    }
+
+    TEST_CASE("see - en passant") {
+        Position pos;
+        pos.setFen("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1");
+
+        const Move move(Square::E5, Square::D6, MoveFlag::MOVE_CAPTURE_EP);
+
+        REQUIRE(search::see(pos, move, 100));
+    }
+
+}
@@ -0,0 +1,160 @@
+#include "commons/pch.h"
+#include "core/position.h"
+#include "core/types.h"
+#include "doctest/doctest.h"
+#include "tb/tablebase.h"
+#include "tb/tbgen.h"
+
+using namespace sagittar;
+
+namespace {
+
+    // Longest win of the table, in moves
+    int longestWin(const std::filesystem::path& dir, const std::string& code) {
+        tb::Material material;
+        REQUIRE(tb::Material::parse(code, &material));
+
+        tb::Table table;
+        REQUIRE(table.open(tb::tablePath(dir, material)));
+
+        int longest = 0;
+        for (const Color c : {Color::WHITE, Color::BLACK})
+        {
+            for (u64 i = 0; i < material.size(); i++)
+            {
+                const u8 value = table.value(c, i);
+                if (value < tb::VALUE_LOSS)
+                {
+                    longest = std::max(longest, static_cast<int>(value));
+                }
+            }
+        }
+        return longest;
+    }
+
+    tb::ProbeResult probe(const std::string& fen) {
+        Position pos;
+        pos.setFen(fen);
+
+        tb::ProbeResult result;
+        REQUIRE(tb::probe(pos, &result));
+        return result;
+    }
+
+}
+
+TEST_SUITE("Tablebase") {
+
+    TEST_CASE("tb::Material") {
+        tb::Material material;
+
+        REQUIRE(tb::Material::parse("KRKQ", &material));
+        CHECK(material.code() == "KQKR");
+        CHECK(material.n == 4);
+        CHECK(material.size() == 10 * 64 * 64 * 64);
+
+        CHECK(!tb::Material::parse("KPK", &material));
+        CHECK(!tb::Material::parse("KQRKRN", &material));
+        CHECK(!tb::Material::parse("QKK", &material));
+
+        CHECK(tb::materialsUpTo(3) == std::vector<std::string>{"KQK", "KRK", "KBK", "KNK"});
+        CHECK(tb::materialsUpTo(4).size() == 24);
+    }
+
+    TEST_CASE("tb::encode") {
+        tb::Material material;
+        REQUIRE(tb::Material::parse("KQKR", &material));
+
+        // Every symmetry of a position has its index
+        for (u64 index = 0; index < material.size(); index += 997)
+        {
+            tb::Squares squares;
+            tb::decode(material, index, &squares);
+            const u64 encoded = tb::encode(material, squares);
+
+            for (const u8 flip : {7, 56, 63})
+            {
+                tb::Squares flipped;
+                for (std::size_t i = 0; i < squares.size(); i++)
+                {
+                    flipped[i] = static_cast<Square>(squares[i] ^ flip);
+                }
+                CHECK(tb::encode(material, flipped) == encoded);
+            }
+
+            tb::Squares transposed;
+            for (std::size_t i = 0; i < squares.size(); i++)
+            {
+                transposed[i] = rf2sq(sq2file(squares[i]), sq2rank(squares[i]));
+            }
+            CHECK(tb::encode(material, transposed) == encoded);
+        }
+    }
+
+    TEST_CASE("tb::generate") {
+        const std::filesystem::path dir =
+          std::filesystem::temp_directory_path() / "sagittar_test_tb";
+        std::filesystem::remove_all(dir);
+
+        // The smaller tables of the captures come first
+        REQUIRE(tb::generate({"KRKQ"}, dir));
+        REQUIRE(tb::load(dir) == 3);
+        CHECK(tb::maxPieces() == 4);
+
+        SUBCASE("longest mates") {
+            CHECK(longestWin(dir, "KQK") == 10);
+            CHECK(longestWin(dir, "KRK") == 16);
+            CHECK(longestWin(dir, "KQKR") == 35);
+        }
+
+        SUBCASE("mates") {
+            tb::ProbeResult result = probe("7k/8/6K1/8/8/8/8/1Q6 w - - 0 1");
+            CHECK(result.wdl == tb::WDL::WIN);
+            CHECK(result.plies == 1);
+
+            result = probe("Q6k/8/6K1/8/8/8/8/8 b - - 0 1");
+            CHECK(result.wdl == tb::WDL::LOSS);
+            CHECK(result.plies == 0);
+
+            // The same with the colors swapped
+            result = probe("1q6/8/8/8/8/6k1/8/7K b - - 0 1");
+            CHECK(result.wdl == tb::WDL::WIN);
+            CHECK(result.plies == 1);
+
+            result = probe("8/8/8/8/8/6k1/8/q6K w - - 0 1");
+            CHECK(result.wdl == tb::WDL::LOSS);
+            CHECK(result.plies == 0);
+        }
+
+        SUBCASE("fifty move rule") {
+            CHECK(probe("7k/8/6K1/8/8/8/8/1Q6 w - - 99 1").wdl == tb::WDL::WIN);
+
+            Position pos;
+            pos.setFen("7k/8/6K1/8/8/8/8/1Q6 w - - 100 1");
+            tb::ProbeResult result;
+            CHECK(!tb::probe(pos, &result));
+        }
+
+        SUBCASE("draws") {
+            // Stalemate
+            CHECK(probe("k7/2Q5/1K6/8/8/8/8/8 b - - 0 1").wdl == tb::WDL::DRAW);
+
+            // The queen hangs
+            CHECK(probe("8/8/8/8/8/8/1k6/Q6K b - - 0 1").wdl == tb::WDL::DRAW);
+
+            // Bare kings need no table
+            CHECK(probe("8/8/8/8/8/6k1/8/7K w - - 0 1").wdl == tb::WDL::DRAW);
+        }
+
+        SUBCASE("missing material") {
+            Position pos;
+            pos.setFen("8/8/8/8/8/6k1/8/B6K w - - 0 1");
+            tb::ProbeResult result;
+            CHECK(!tb::probe(pos, &result));
+        }
+
+        CHECK(tb::load({}) == 0);
+        std::filesystem::remove_all(dir);
+    }
+
+}
@@ -28,7 +28,7 @@ TEST_SUITE("TT") {
 
         Move m(Square::E2, Square::E4, MoveFlag::MOVE_QUIET_PAWN_DBL_PUSH);
 
-        tt.store(pos.key(), 0, 1, search::TTFlag::EXACT, 10, m);
+        tt.store(pos.key(), 0, 1, search::TTFlag::EXACT, 10, m, 25, true);
 
         search::TTData ttdata;
 
@@ -38,14 +38,16 @@ TEST_SUITE("TT") {
         REQUIRE(ttdata.depth == 1);
         REQUIRE(ttdata.flag == search::TTFlag::EXACT);
         REQUIRE(ttdata.score == 10);
+        REQUIRE(ttdata.eval == 25);
         REQUIRE(ttdata.move == m);
+        REQUIRE(ttdata.pv == true);
 
         std::string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
         pos.setFen(fen);
 
         m = Move(Square::E2, Square::A6, MoveFlag::MOVE_CAPTURE);
 
-        tt.store(pos.key(), 0, 3, search::TTFlag::LOWERBOUND, 100, m);
+        tt.store(pos.key(), 0, 3, search::TTFlag::LOWERBOUND, 100, m, -40, false);
 
         tthit = tt.probe(&ttdata, pos.key());
 
@@ -53,7 +55,9 @@ TEST_SUITE("TT") {
         REQUIRE(ttdata.depth == 3);
         REQUIRE(ttdata.flag == search::TTFlag::LOWERBOUND);
         REQUIRE(ttdata.score == 100);
+        REQUIRE(ttdata.eval == -40);
         REQUIRE(ttdata.move == m);
+        REQUIRE(ttdata.pv == false);
     }
 
     TEST_CASE("Null Move Replacement from the same position") {
@@ -68,7 +72,7 @@ TEST_SUITE("TT") {
 
         const Move m = Move(Square::E2, Square::A6, MoveFlag::MOVE_CAPTURE);
 
-        tt.store(pos.key(), 0, 3, search::TTFlag::EXACT, 100, m);
+        tt.store(pos.key(), 0, 3, search::TTFlag::EXACT, 100, m, 0, false);
 
         search::TTData ttdata;
         bool           tthit = tt.probe(&ttdata, pos.key());
@@ -81,7 +85,7 @@ TEST_SUITE("TT") {
 
         const Move nullmove;
 
-        tt.store(pos.key(), 0, 5, search::TTFlag::LOWERBOUND, 50, nullmove);
+        tt.store(pos.key(), 0, 5, search::TTFlag::LOWERBOUND, 50, nullmove, 0, false);
 
         tthit = tt.probe(&ttdata, pos.key());
 